@@ -1,4 +1,4 @@
-// Copyright 2020-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright 2020-2026, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Redistribution and use in source and binary forms, with or without
 // modification, are permitted provided that the following conditions
@@ -25,35 +25,163 @@
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
 #include "error.h"
+#include "strand_executor.h"
 #include "thread_pool.h"
+#include "timer_wheel.h"
 
 namespace triton { namespace common {
+
+//
+// Named pool of asynchronous worker threads, e.g. one for model load I/O
+// and one for response completion so that a slow load does not hold back
+// inference responses. Each queue has its own worker threads and metrics.
+// Queues are usually obtained with AsyncWorkQueue::Get, which registers
+// them by name.
+//
+class WorkQueue {
+ public:
+  explicit WorkQueue(const std::string& name) : name_(name) {}
+  ~WorkQueue();
+
+  WorkQueue(const WorkQueue&) = delete;
+  WorkQueue& operator=(const WorkQueue&) = delete;
+
+  const std::string& Name() const { return name_; }
+
+  // Start 'worker_count' number of worker threads.
+  Error Initialize(size_t worker_count);
+
+  // Start the worker threads with the thread pool configuration given in
+  // 'options', e.g. to enable priority levels.
+  Error Initialize(const ThreadPool::Options& options);
+
+  // Get the number of worker threads, 0 if not initialized.
+  size_t WorkerCount() const;
+
+  // Get a snapshot of the worker thread metrics, see
+  // ThreadPool::GetMetrics.
+  Error GetMetrics(ThreadPool::Metrics* metrics) const;
+
+  // Add a 'task' to the queue. The function will take ownership of 'task'.
+  // Therefore std::move should be used when calling AddTask.
+  Error AddTask(std::function<void(void)>&& task, uint32_t priority_level = 0);
+
+  // Add a 'task' that runs after, and never concurrently with, the tasks
+  // previously added with the same 'key', e.g. the correlation ID of a
+  // sequence. Tasks of different keys run in parallel, see StrandExecutor.
+  Error AddSerialTask(uint64_t key, std::function<void(void)>&& task);
+
+  // Add a 'task' to the queue once 'deadline' is reached. If 'timer_id'
+  // is not nullptr it returns the ID to cancel the task with. The timer
+  // thread of the queue is started on first use, see TimerWheel.
+  Error AddTaskAt(
+      std::chrono::steady_clock::time_point deadline,
+      std::function<void(void)>&& task,
+      TimerWheel::TimerId* timer_id = nullptr);
+
+  // Same as above but 'task' is added after 'delay'.
+  Error AddTaskAfter(
+      std::chrono::microseconds delay, std::function<void(void)>&& task,
+      TimerWheel::TimerId* timer_id = nullptr);
+
+  // Cancel the delayed task 'timer_id'. Returns NOT_FOUND if the task has
+  // already been added to the queue or cancelled.
+  Error CancelTask(TimerWheel::TimerId timer_id);
+
+ private:
+  TimerWheel* Timers();
+
+  const std::string name_;
+  std::mutex init_mtx_;
+  std::unique_ptr<ThreadPool> thread_pool_;
+  std::unique_ptr<StrandExecutor<uint64_t>> strands_;
+  std::once_flag timers_once_;
+  std::unique_ptr<TimerWheel> timers_;
+  // Set once 'timers_' is created, so that cancelling does not create it.
+  std::atomic<bool> has_timers_{false};
+};
+
 // Manager for asynchronous worker threads. Use to accelerate copies and
 // other such operations by running them in parallel.
 // Call Initialize to start the worker threads (once) and AddTask to tasks to
-// the queue.
+// the queue. The static functions operate on the default queue, other
+// queues are created by name with Get.
 
 class AsyncWorkQueue {
  public:
+  // Name of the queue used by the static functions below.
+  static constexpr const char* kDefaultQueue = "default";
+
+  // Get the queue registered as 'name', registering a new, uninitialized
+  // queue if there is none. The queue lives until the process exits.
+  static WorkQueue* Get(const std::string& name);
+
+  // Get the names of the registered queues in lexical order.
+  static std::vector<std::string> QueueNames();
+
   // Start 'worker_count' number of worker threads.
   static Error Initialize(size_t worker_count);
 
+  // Start the worker threads with the thread pool configuration given in
+  // 'options', e.g. to enable priority levels.
+  static Error Initialize(const ThreadPool::Options& options);
+
   // Get the number of worker threads.
   static size_t WorkerCount();
 
+  // Get a snapshot of the worker thread metrics, see
+  // ThreadPool::GetMetrics.
+  static Error GetMetrics(ThreadPool::Metrics* metrics);
+
   // Add a 'task' to the queue. The function will take ownership of 'task'.
   // Therefore std::move should be used when calling AddTask.
   static Error AddTask(std::function<void(void)>&& task);
 
+  // Same as above but 'task' is queued at 'priority_level', see
+  // ThreadPool::Enqueue.
+  static Error AddTask(
+      std::function<void(void)>&& task, uint32_t priority_level);
+
+  // See WorkQueue::AddSerialTask.
+  static Error AddSerialTask(
+      uint64_t key, std::function<void(void)>&& task);
+
+  // See WorkQueue::AddTaskAt.
+  static Error AddTaskAt(
+      std::chrono::steady_clock::time_point deadline,
+      std::function<void(void)>&& task,
+      TimerWheel::TimerId* timer_id = nullptr);
+
+  // See WorkQueue::AddTaskAfter.
+  static Error AddTaskAfter(
+      std::chrono::microseconds delay, std::function<void(void)>&& task,
+      TimerWheel::TimerId* timer_id = nullptr);
+
+  // See WorkQueue::CancelTask.
+  static Error CancelTask(TimerWheel::TimerId timer_id);
+
  protected:
+  // Stop and unregister all queues, invalidating the queues returned by
+  // Get.
   static void Reset();
 
  private:
-  AsyncWorkQueue() = default;
+  AsyncWorkQueue();
   ~AsyncWorkQueue();
   static AsyncWorkQueue* GetSingleton();
-  std::unique_ptr<ThreadPool> thread_pool_;
+  std::mutex registry_mtx_;
+  std::map<std::string, std::unique_ptr<WorkQueue>> queues_;
+  WorkQueue* default_queue_;
 };
 
 }}  // namespace triton::common
@@ -0,0 +1,319 @@
+// Copyright 2026, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+//
+// Format of the binary log, see Logger::SetBinaryLog(). Each logging thread
+// writes its records to the ring file '<directory>/triton.<pid>.<tid>.blog'
+// and the LOG_VERBOSE_FMT call sites are described in the sites file
+// '<directory>/triton.<pid>.sites'. Both are rendered by triton-log-decode.
+//
+// A sites file holds kLogBinarySitesMagic, kLogBinaryVersion and the pid
+// as uint32s, then per call site its uint32 id, its int32 line, and its
+// file and format as uint32 sizes followed by the characters. Integers are
+// in host byte order.
+//
+
+namespace triton { namespace common {
+
+constexpr char kLogBinaryRingMagic[8] = {'T', 'R', 'T', 'N',
+                                         'B', 'L', 'O', 'G'};
+constexpr char kLogBinarySitesMagic[8] = {'T', 'R', 'T', 'N',
+                                          'S', 'I', 'T', 'E'};
+constexpr uint32_t kLogBinaryVersion = 1;
+
+// Header of a ring file, followed by 'capacity' bytes of records. The
+// records from offset 'tail' to offset 'head', modulo 'capacity', are
+// valid. Both offsets only grow, the writer moves 'tail' past the records
+// it is about to overwrite.
+struct LogBinaryRingHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t pid;
+  uint64_t tid;
+  uint64_t capacity;
+  std::atomic<uint64_t> head;
+  std::atomic<uint64_t> tail;
+  char reserved[16];
+};
+static_assert(sizeof(LogBinaryRingHeader) == 64, "unexpected ring header size");
+
+// Header of a record, followed by its values and padded to a multiple of
+// 8 bytes. 'site' is the id of the LOG_VERBOSE_FMT call site, whose values
+// are the arguments of the format, or one of the sites below.
+struct LogBinaryRecordHeader {
+  uint32_t size;
+  uint32_t site;
+  uint64_t timestamp_ns;
+};
+
+// Record of a LogMessage, whose values are the level, whether it is
+// verbose, whether its heading and its message are escaped, the line, the
+// file, the heading, empty if none, and the message.
+constexpr uint32_t kLogBinaryMessageSite = 0;
+// Unused end of the ring, only 'size' and 'site' are set.
+constexpr uint32_t kLogBinaryPaddingSite = UINT32_MAX;
+
+// Whether T is a narrow or a wide character type. operator<< writes narrow
+// characters as characters and wide ones depending on the language mode,
+// so neither is stored as an integer.
+template <typename T>
+constexpr bool kLogBinaryNarrowCharacter =
+    std::is_same<T, char>::value || std::is_same<T, signed char>::value ||
+    std::is_same<T, unsigned char>::value;
+template <typename T>
+constexpr bool kLogBinaryWideCharacter =
+#ifdef __cpp_char8_t
+    std::is_same<T, char8_t>::value ||
+#endif
+    std::is_same<T, wchar_t>::value || std::is_same<T, char16_t>::value ||
+    std::is_same<T, char32_t>::value;
+
+//
+// A value of a record: a one-character tag followed by a 64-bit integer or
+// double, a single byte for booleans and narrow characters, or a uint32
+// size followed by the characters of a string. Values of other types,
+// including the wide characters, are written as the string formatted by
+// their operator<<.
+//
+class LogBinaryValue {
+ public:
+  LogBinaryValue() = default;
+  LogBinaryValue(bool value) : tag_('b'), u_(value) {}
+  LogBinaryValue(char value) : tag_('c'), u_(static_cast<uint8_t>(value)) {}
+  LogBinaryValue(signed char value)
+      : tag_('c'), u_(static_cast<uint8_t>(value))
+  {
+  }
+  LogBinaryValue(unsigned char value) : tag_('c'), u_(value) {}
+  template <
+      typename T, std::enable_if_t<
+                      std::is_integral<T>::value && std::is_signed<T>::value &&
+                          !kLogBinaryNarrowCharacter<T> &&
+                          !kLogBinaryWideCharacter<T>,
+                      int> = 0>
+  LogBinaryValue(T value) : tag_('i'), i_(value)
+  {
+  }
+  template <
+      typename T,
+      std::enable_if_t<
+          std::is_integral<T>::value && std::is_unsigned<T>::value &&
+              !std::is_same<T, bool>::value &&
+              !kLogBinaryNarrowCharacter<T> && !kLogBinaryWideCharacter<T>,
+          int> = 0>
+  LogBinaryValue(T value) : tag_('u'), u_(value)
+  {
+  }
+  template <
+      typename T, std::enable_if_t<std::is_floating_point<T>::value, int> = 0>
+  LogBinaryValue(T value) : tag_('d'), d_(value)
+  {
+  }
+  LogBinaryValue(const char* value)
+      : tag_('s'), str_((value != nullptr) ? value : "(null)")
+  {
+  }
+  LogBinaryValue(std::string_view value) : tag_('s'), str_(value) {}
+  LogBinaryValue(const std::string& value) : tag_('s'), str_(value) {}
+  template <
+      typename T,
+      std::enable_if_t<
+          (!std::is_arithmetic<T>::value || kLogBinaryWideCharacter<T>) &&
+              !std::is_convertible<const T&, std::string_view>::value,
+          int> = 0>
+  LogBinaryValue(const T& value) : tag_('s')
+  {
+    std::ostringstream out;
+    out << value;
+    owned_ = out.str();
+    str_ = owned_;
+  }
+
+  LogBinaryValue(const LogBinaryValue&) = delete;
+  LogBinaryValue& operator=(const LogBinaryValue&) = delete;
+
+  // Number of bytes written by Write().
+  size_t Size() const
+  {
+    switch (tag_) {
+      case 'b':
+      case 'c':
+        return 2;
+      case 's':
+        return 1 + sizeof(uint32_t) + str_.size();
+      default:
+        return 1 + sizeof(uint64_t);
+    }
+  }
+
+  // Write the value to 'out', returns the end of the value.
+  char* Write(char* out) const
+  {
+    *out++ = tag_;
+    switch (tag_) {
+      case 'b':
+      case 'c':
+        *out++ = static_cast<char>(u_);
+        return out;
+      case 's': {
+        const uint32_t size = static_cast<uint32_t>(str_.size());
+        std::memcpy(out, &size, sizeof(size));
+        std::memcpy(out + sizeof(size), str_.data(), size);
+        return out + sizeof(size) + size;
+      }
+      default:
+        std::memcpy(out, &u_, sizeof(u_));
+        return out + sizeof(u_);
+    }
+  }
+
+  // Read a value written by Write() from 'in', which ends at 'end'. Strings
+  // refer to 'in'. Returns the end of the value, nullptr if it is invalid.
+  const char* Read(const char* in, const char* end)
+  {
+    if (in == end) {
+      return nullptr;
+    }
+    tag_ = *in++;
+    switch (tag_) {
+      case 'b':
+      case 'c':
+        if (in == end) {
+          return nullptr;
+        }
+        u_ = static_cast<uint8_t>(*in);
+        return in + 1;
+      case 's': {
+        uint32_t size;
+        if (static_cast<size_t>(end - in) < sizeof(size)) {
+          return nullptr;
+        }
+        std::memcpy(&size, in, sizeof(size));
+        in += sizeof(size);
+        if (static_cast<size_t>(end - in) < size) {
+          return nullptr;
+        }
+        str_ = std::string_view(in, size);
+        return in + size;
+      }
+      case 'i':
+      case 'u':
+      case 'd':
+        if (static_cast<size_t>(end - in) < sizeof(u_)) {
+          return nullptr;
+        }
+        std::memcpy(&u_, in, sizeof(u_));
+        return in + sizeof(u_);
+      default:
+        return nullptr;
+    }
+  }
+
+  char Tag() const { return tag_; }
+  int64_t Int() const { return i_; }
+  uint64_t UInt() const { return u_; }
+  double Double() const { return d_; }
+  std::string_view String() const { return str_; }
+
+  // Write the value as operator<< writes the original one.
+  friend std::ostream& operator<<(std::ostream& out, const LogBinaryValue& v)
+  {
+    switch (v.tag_) {
+      case 'b':
+        return out << (v.u_ != 0);
+      case 'c':
+        return out << static_cast<char>(v.u_);
+      case 'i':
+        return out << v.i_;
+      case 'u':
+        return out << v.u_;
+      case 'd':
+        return out << v.d_;
+      default:
+        return out << v.str_;
+    }
+  }
+
+ private:
+  char tag_ = 's';
+  union {
+    int64_t i_;
+    uint64_t u_ = 0;
+    double d_;
+  };
+  std::string_view str_;
+  std::string owned_;
+};
+
+// Call 'fn(header, values, values_end)' for each record of the ring file
+// mapped at 'ring' of 'size' bytes, from the oldest. Returns false if the
+// file is not a valid ring file.
+template <typename Fn>
+bool
+ForEachLogBinaryRecord(const char* ring, size_t size, Fn fn)
+{
+  const auto* header = reinterpret_cast<const LogBinaryRingHeader*>(ring);
+  if ((size < sizeof(LogBinaryRingHeader)) ||
+      (std::memcmp(header->magic, kLogBinaryRingMagic, 8) != 0) ||
+      (header->version != kLogBinaryVersion) ||
+      (size < sizeof(LogBinaryRingHeader) + header->capacity)) {
+    return false;
+  }
+  const char* data = ring + sizeof(LogBinaryRingHeader);
+  const uint64_t capacity = header->capacity;
+  const uint64_t head = header->head.load(std::memory_order_acquire);
+  for (uint64_t offset = header->tail.load(std::memory_order_acquire);
+       offset < head;) {
+    const char* record = data + (offset % capacity);
+    LogBinaryRecordHeader record_header;
+    std::memcpy(&record_header, record, 2 * sizeof(uint32_t));
+    if ((record_header.size < 2 * sizeof(uint32_t)) ||
+        ((offset % capacity) + record_header.size > capacity)) {
+      return false;
+    }
+    if (record_header.site != kLogBinaryPaddingSite) {
+      if (record_header.size < sizeof(record_header)) {
+        return false;
+      }
+      std::memcpy(&record_header, record, sizeof(record_header));
+      fn(record_header, record + sizeof(record_header),
+         record + record_header.size);
+    }
+    offset += record_header.size;
+  }
+  return true;
+}
+
+}}  // namespace triton::common
@@ -0,0 +1,446 @@
+// Copyright 2026, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include "free_list.h"
+#include "sync_queue.h"
+#include "task_future.h"
+#include "thread_pool.h"
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#define TRITON_COMMON_ENABLE_COROUTINES
+#endif
+
+#ifdef TRITON_COMMON_ENABLE_COROUTINES
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace triton { namespace common {
+
+//
+// C++20 coroutine support, available when the compiler supports
+// coroutines (TRITON_COMMON_ENABLE_COROUTINES is then defined). It only
+// uses the public interface of ThreadPool, whose definition is the same in
+// every language mode.
+//
+// A Task<T> is a lazily started coroutine returning T. It starts when
+// awaited, 'co_await task', or when Get() is called from a regular
+// function, and hops between threads by awaiting Schedule() on a
+// ThreadPool or AsyncGet() on a SyncQueue:
+//
+//   Task<int> Stage(ThreadPool* pool, SyncQueue<int>* queue)
+//   {
+//     std::optional<int> value = co_await AsyncGet(queue, pool);
+//     co_await Schedule(*pool);
+//     co_return value ? *value * 2 : 0;
+//   }
+//
+// Coroutine frames are allocated from recycled blocks, see
+// CoroutineFrameAllocator.
+//
+
+// Recycles coroutine frames in power-of-two size classes, frames larger
+// than the largest class come from the heap.
+class CoroutineFrameAllocator {
+ public:
+  static void* Allocate(size_t size)
+  {
+    const size_t size_class = SizeClass(size);
+    if (size_class == kClasses) {
+      return ::operator new(size);
+    }
+    return Lists()[size_class].Allocate();
+  }
+
+  static void Deallocate(void* frame, size_t size)
+  {
+    const size_t size_class = SizeClass(size);
+    if (size_class == kClasses) {
+      ::operator delete(frame);
+    } else {
+      Lists()[size_class].Deallocate(frame);
+    }
+  }
+
+ private:
+  // Classes of 64 bytes to 4 KB
+  static constexpr size_t kMinShift = 6;
+  static constexpr size_t kClasses = 7;
+
+  static size_t SizeClass(size_t size)
+  {
+    size_t size_class = 0;
+    while ((size_class < kClasses) &&
+           (size > (size_t(1) << (kMinShift + size_class)))) {
+      ++size_class;
+    }
+    return size_class;
+  }
+
+  static FreeList* Lists()
+  {
+    struct FrameLists {
+      FreeList lists_[kClasses] = {FreeList(64),   FreeList(128),
+                                   FreeList(256),  FreeList(512),
+                                   FreeList(1024), FreeList(2048),
+                                   FreeList(4096)};
+    };
+    // Never destroyed, coroutines may be destroyed during static
+    // destruction
+    static FrameLists* frame_lists = new FrameLists();
+    return frame_lists->lists_;
+  }
+};
+
+template <typename T>
+class Task;
+
+namespace detail {
+
+// Pool task resuming the coroutine '*handle', setting '*scheduled' if it
+// runs. If it is destroyed without running, because the pool discarded it
+// at shutdown, the coroutine resumes on the destroying thread instead,
+// unless '*handle' was reset.
+class CoroutineResumer {
+ public:
+  CoroutineResumer(std::coroutine_handle<>* handle, bool* scheduled)
+      : handle_(handle), scheduled_(scheduled)
+  {
+  }
+  CoroutineResumer(CoroutineResumer&& other) noexcept
+      : handle_(other.handle_), scheduled_(other.scheduled_)
+  {
+    other.handle_ = nullptr;
+  }
+  CoroutineResumer& operator=(CoroutineResumer&&) = delete;
+  ~CoroutineResumer()
+  {
+    if ((handle_ != nullptr) && *handle_) {
+      handle_->resume();
+    }
+  }
+
+  void operator()()
+  {
+    std::coroutine_handle<> handle = *handle_;
+    handle_ = nullptr;
+    *scheduled_ = true;
+    handle.resume();
+  }
+
+ private:
+  std::coroutine_handle<>* handle_;
+  bool* scheduled_;
+};
+
+class CoroutinePromiseBase {
+ public:
+  static void* operator new(size_t size)
+  {
+    return CoroutineFrameAllocator::Allocate(size);
+  }
+
+  static void operator delete(void* frame, size_t size)
+  {
+    CoroutineFrameAllocator::Deallocate(frame, size);
+  }
+
+  // Resumes the awaiting coroutine, or wakes the thread blocked in
+  // Task::Get(), once the coroutine completes.
+  struct FinalAwaiter {
+    bool await_ready() const noexcept { return false; }
+
+    template <typename Promise>
+    std::coroutine_handle<> await_suspend(
+        std::coroutine_handle<Promise> handle) noexcept
+    {
+      CoroutinePromiseBase& promise = handle.promise();
+      if (promise.continuation_) {
+        return promise.continuation_;
+      }
+      if (promise.waiter_) {
+        // The frame may be destroyed as soon as the waiter is woken
+        TaskPromise<void> waiter(std::move(*promise.waiter_));
+        promise.waiter_.reset();
+        waiter.SetFrom([]() {});
+      }
+      return std::noop_coroutine();
+    }
+
+    void await_resume() const noexcept {}
+  };
+
+  std::suspend_always initial_suspend() const noexcept { return {}; }
+
+  FinalAwaiter final_suspend() const noexcept { return {}; }
+
+  void unhandled_exception() { exception_ = std::current_exception(); }
+
+ protected:
+  template <typename T>
+  friend class triton::common::Task;
+
+  void RethrowIfFailed()
+  {
+    if (exception_) {
+      std::rethrow_exception(exception_);
+    }
+  }
+
+  std::coroutine_handle<> continuation_;
+  std::optional<TaskPromise<void>> waiter_;
+  std::exception_ptr exception_;
+};
+
+template <typename T>
+class CoroutinePromise : public CoroutinePromiseBase {
+ public:
+  Task<T> get_return_object();
+
+  template <typename U>
+  void return_value(U&& value)
+  {
+    value_.emplace(std::forward<U>(value));
+  }
+
+  T Result()
+  {
+    RethrowIfFailed();
+    return std::move(*value_);
+  }
+
+ private:
+  std::optional<T> value_;
+};
+
+template <>
+class CoroutinePromise<void> : public CoroutinePromiseBase {
+ public:
+  Task<void> get_return_object();
+
+  void return_void() {}
+
+  void Result() { RethrowIfFailed(); }
+};
+
+}  // namespace detail
+
+template <typename T = void>
+class [[nodiscard]] Task {
+ public:
+  using promise_type = detail::CoroutinePromise<T>;
+
+  Task() = default;
+  explicit Task(std::coroutine_handle<promise_type> handle) : handle_(handle)
+  {
+  }
+  Task(Task&& other) noexcept : handle_(other.handle_)
+  {
+    other.handle_ = nullptr;
+  }
+  Task& operator=(Task&& other) noexcept
+  {
+    if (this != &other) {
+      Reset();
+      handle_ = other.handle_;
+      other.handle_ = nullptr;
+    }
+    return *this;
+  }
+  Task(const Task&) = delete;
+  Task& operator=(const Task&) = delete;
+  ~Task() { Reset(); }
+
+  // Whether the task refers to a coroutine.
+  bool Valid() const { return static_cast<bool>(handle_); }
+
+  // Runs the coroutine on the calling thread until its first suspension
+  // and blocks until it completes. Returns its result or rethrows its
+  // exception. Must not be called on a started task.
+  T Get()
+  {
+    TaskState<void>* state = TaskState<void>::Create(nullptr);
+    TaskFuture<void> done(state);
+    handle_.promise().waiter_.emplace(state);
+    handle_.resume();
+    done.Get();
+    return handle_.promise().Result();
+  }
+
+  // Awaiting a task starts it and resumes the awaiting coroutine, on the
+  // thread the task completes on, with its result.
+  bool await_ready() const noexcept { return false; }
+
+  std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting)
+  {
+    handle_.promise().continuation_ = awaiting;
+    return handle_;
+  }
+
+  T await_resume() { return handle_.promise().Result(); }
+
+ private:
+  void Reset()
+  {
+    if (handle_) {
+      handle_.destroy();
+      handle_ = nullptr;
+    }
+  }
+
+  std::coroutine_handle<promise_type> handle_;
+};
+
+namespace detail {
+
+template <typename T>
+Task<T>
+CoroutinePromise<T>::get_return_object()
+{
+  return Task<T>(std::coroutine_handle<CoroutinePromise<T>>::from_promise(
+      *this));
+}
+
+inline Task<void>
+CoroutinePromise<void>::get_return_object()
+{
+  return Task<void>(
+      std::coroutine_handle<CoroutinePromise<void>>::from_promise(*this));
+}
+
+}  // namespace detail
+
+//
+// Awaitable resuming the awaiting coroutine on a worker of a ThreadPool,
+// see Schedule().
+//
+class ScheduleAwaiter {
+ public:
+  ScheduleAwaiter(ThreadPool* pool, uint32_t priority_level)
+      : pool_(pool), priority_level_(priority_level)
+  {
+  }
+
+  bool await_ready() const noexcept { return false; }
+
+  bool await_suspend(std::coroutine_handle<> handle)
+  {
+    handle_ = handle;
+    ThreadPool::Task task(detail::CoroutineResumer(&handle_, &scheduled_));
+    if (pool_->Enqueue(std::move(task), priority_level_)) {
+      return true;
+    }
+    // Rejected, resume by not suspending rather than from the destructor of
+    // the task, which only resumes tasks discarded at shutdown
+    handle_ = nullptr;
+    return false;
+  }
+
+  bool await_resume() const noexcept { return scheduled_; }
+
+ private:
+  ThreadPool* pool_;
+  const uint32_t priority_level_;
+  std::coroutine_handle<> handle_;
+  bool scheduled_ = false;
+};
+
+// Returns an awaitable that resumes the awaiting coroutine on a worker
+// thread of 'pool', queued at 'priority_level', without allocating:
+//
+//   co_await Schedule(pool);
+//
+// The co_await evaluates to false if the pool rejected or discarded the
+// continuation, in which case the coroutine has resumed on the thread
+// that did so.
+inline ScheduleAwaiter
+Schedule(ThreadPool& pool, uint32_t priority_level = 0)
+{
+  return ScheduleAwaiter(&pool, priority_level);
+}
+
+//
+// Awaitable getting an item from a SyncQueue without blocking a thread,
+// see AsyncGet().
+//
+template <typename Item>
+class SyncQueueGetAwaiter : private SyncQueue<Item>::AsyncWaiter {
+ public:
+  SyncQueueGetAwaiter(SyncQueue<Item>* queue, ThreadPool* pool)
+      : queue_(queue), pool_(pool)
+  {
+    this->notify = &Notify;
+  }
+
+  bool await_ready() const noexcept { return false; }
+
+  bool await_suspend(std::coroutine_handle<> handle)
+  {
+    handle_ = handle;
+    return !queue_->GetOrWait(this);
+  }
+
+  // Returns an empty optional if the queue is closed and drained.
+  std::optional<Item> await_resume() { return std::move(this->item); }
+
+ private:
+  static void Notify(typename SyncQueue<Item>::AsyncWaiter* waiter)
+  {
+    SyncQueueGetAwaiter* self = static_cast<SyncQueueGetAwaiter*>(waiter);
+    if (self->pool_ == nullptr) {
+      self->handle_.resume();
+    } else {
+      // Resumes here if the pool is shut down
+      self->pool_->Enqueue(
+          detail::CoroutineResumer(&self->handle_, &self->on_pool_));
+    }
+  }
+
+  SyncQueue<Item>* queue_;
+  ThreadPool* pool_;
+  std::coroutine_handle<> handle_;
+  bool on_pool_ = false;
+};
+
+// Returns an awaitable that evaluates to the next item of 'queue', or to an
+// empty optional once the queue is closed and drained. While the queue is
+// empty the coroutine is suspended instead of blocking, and
+// it resumes on a worker of 'pool', or on the thread that put the item if
+// 'pool' is nullptr.
+template <typename Item>
+SyncQueueGetAwaiter<Item>
+AsyncGet(SyncQueue<Item>* queue, ThreadPool* pool = nullptr)
+{
+  return SyncQueueGetAwaiter<Item>(queue, pool);
+}
+
+}}  // namespace triton::common
+
+#endif  // TRITON_COMMON_ENABLE_COROUTINES
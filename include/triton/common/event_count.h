@@ -0,0 +1,219 @@
+// Copyright 2026, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#else
+#include <condition_variable>
+#include <mutex>
+#endif
+
+namespace triton { namespace common {
+
+// Hint to the CPU that the caller is busy-waiting.
+inline void
+CpuRelax()
+{
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__)
+  asm volatile("yield" ::: "memory");
+#endif
+}
+
+//
+// EventCount lets threads wait for a condition that is checked without a
+// lock, while the notifying side only makes a system call when some thread
+// is waiting and has not been signalled yet. Notifications issued while a
+// woken thread is still getting scheduled therefore cost no system call.
+//
+// Waiting protocol:
+//
+//   if (!condition()) {
+//     ec.PrepareWait();
+//     if (condition()) {
+//       ec.CancelWait();
+//     } else {
+//       ec.Wait();
+//     }
+//   }
+//
+// The notifier makes the condition true and then calls Notify() or
+// NotifyAll().
+//
+class EventCount {
+ public:
+  EventCount() : val_(0) {}
+  EventCount(const EventCount&) = delete;
+  EventCount& operator=(const EventCount&) = delete;
+
+  // Wake one waiter, if any is not signalled yet.
+  void Notify() { DoNotify(false); }
+
+  // Wake all waiters, if any.
+  void NotifyAll() { DoNotify(true); }
+
+  // Register the calling thread as a waiter. The condition must be checked
+  // again after this returns, followed by either CancelWait() or Wait().
+  void PrepareWait()
+  {
+    val_.fetch_add(kAddWaiter, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+  }
+
+  // Unregister a waiter that found the condition true after PrepareWait().
+  void CancelWait()
+  {
+    uint64_t state = val_.load(std::memory_order_relaxed);
+    while (true) {
+      uint64_t next = state - kAddWaiter;
+      // Whether this thread was signalled is unknown, but if every waiter
+      // was, one of the signals is this thread's and must go away with it.
+      if (Waiters(state) == Signals(state)) {
+        next -= kAddSignal;
+      }
+      if (val_.compare_exchange_weak(
+              state, next, std::memory_order_acq_rel,
+              std::memory_order_relaxed)) {
+        return;
+      }
+    }
+  }
+
+  // Block until a signal is available and consume it.
+  void Wait()
+  {
+    uint64_t state = val_.load(std::memory_order_acquire);
+    while (true) {
+      if (Signals(state) == 0) {
+        Park(Epoch(state));
+        state = val_.load(std::memory_order_acquire);
+        continue;
+      }
+      if (val_.compare_exchange_weak(
+              state, state - kAddWaiter - kAddSignal,
+              std::memory_order_acq_rel, std::memory_order_acquire)) {
+        return;
+      }
+    }
+  }
+
+ private:
+  // Low 16 bits count the registered waiters, the next 16 bits the signals
+  // not consumed yet, and the high 32 bits are the epoch, bumped by every
+  // signal. The epoch is the futex word.
+  static constexpr uint64_t kAddWaiter = 1;
+  static constexpr uint64_t kWaiterMask = 0xFFFF;
+  static constexpr int kSignalShift = 16;
+  static constexpr uint64_t kAddSignal = uint64_t(1) << kSignalShift;
+  static constexpr int kEpochShift = 32;
+  static constexpr uint64_t kAddEpoch = uint64_t(1) << kEpochShift;
+
+  static uint64_t Waiters(uint64_t state) { return state & kWaiterMask; }
+  static uint64_t Signals(uint64_t state)
+  {
+    return (state >> kSignalShift) & kWaiterMask;
+  }
+  static uint32_t Epoch(uint64_t state)
+  {
+    return static_cast<uint32_t>(state >> kEpochShift);
+  }
+
+  void DoNotify(bool all)
+  {
+    // Pairs with the fence in PrepareWait(): either the waiter sees the
+    // condition or this sees the waiter.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    uint64_t state = val_.load(std::memory_order_relaxed);
+    while (true) {
+      const uint64_t unsignalled = Waiters(state) - Signals(state);
+      if (unsignalled == 0) {
+        return;
+      }
+      const uint64_t next =
+          state + kAddEpoch + (all ? unsignalled : 1) * kAddSignal;
+      if (val_.compare_exchange_weak(
+              state, next, std::memory_order_acq_rel,
+              std::memory_order_relaxed)) {
+        break;
+      }
+    }
+#ifdef __linux__
+    syscall(
+        SYS_futex, EpochAddress(), FUTEX_WAKE_PRIVATE, all ? INT32_MAX : 1,
+        nullptr, nullptr, 0);
+#else
+    std::lock_guard<std::mutex> lk(mu_);
+    if (all) {
+      cv_.notify_all();
+    } else {
+      cv_.notify_one();
+    }
+#endif
+  }
+
+  // Sleep until the epoch moves past 'epoch', or spuriously.
+  void Park(uint32_t epoch)
+  {
+#ifdef __linux__
+    syscall(
+        SYS_futex, EpochAddress(), FUTEX_WAIT_PRIVATE, epoch, nullptr, nullptr,
+        0);
+#else
+    std::unique_lock<std::mutex> lk(mu_);
+    cv_.wait(lk, [this, epoch]() {
+      return Epoch(val_.load(std::memory_order_acquire)) != epoch;
+    });
+#endif
+  }
+
+#ifdef __linux__
+  void* EpochAddress()
+  {
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    return reinterpret_cast<uint32_t*>(&val_) + 1;
+#else
+    return reinterpret_cast<uint32_t*>(&val_);
+#endif
+  }
+#else
+  std::mutex mu_;
+  std::condition_variable cv_;
+#endif
+
+  std::atomic<uint64_t> val_;
+  static_assert(
+      sizeof(std::atomic<uint64_t>) == sizeof(uint64_t),
+      "EventCount requires a lock-free 64-bit atomic");
+};
+
+}}  // namespace triton::common
@@ -0,0 +1,101 @@
+// Copyright 2026, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <new>
+
+namespace triton { namespace common {
+
+//
+// Thread-safe free list of fixed-size memory blocks. Released blocks are
+// kept for reuse and only returned to the system when the free list is
+// destroyed, so allocation is free of heap traffic in steady state.
+//
+class FreeList {
+ public:
+  explicit FreeList(size_t block_size)
+      : block_size_(
+            (block_size < sizeof(Node)) ? sizeof(Node)
+                                        : RoundUp(block_size))
+  {
+  }
+
+  ~FreeList()
+  {
+    while (head_ != nullptr) {
+      Node* next = head_->next;
+      ::operator delete(head_);
+      head_ = next;
+    }
+  }
+
+  FreeList(const FreeList&) = delete;
+  FreeList& operator=(const FreeList&) = delete;
+
+  size_t BlockSize() const { return block_size_; }
+
+  // Returns a block of 'BlockSize()' bytes aligned for any scalar type.
+  void* Allocate()
+  {
+    {
+      std::lock_guard<std::mutex> lk(mu_);
+      if (head_ != nullptr) {
+        Node* node = head_;
+        head_ = node->next;
+        return node;
+      }
+    }
+    return ::operator new(block_size_);
+  }
+
+  // Returns 'block', obtained from Allocate(), to the free list.
+  void Deallocate(void* block)
+  {
+    Node* node = static_cast<Node*>(block);
+    std::lock_guard<std::mutex> lk(mu_);
+    node->next = head_;
+    head_ = node;
+  }
+
+ private:
+  struct Node {
+    Node* next;
+  };
+
+  static size_t RoundUp(size_t size)
+  {
+    constexpr size_t kAlign = alignof(std::max_align_t);
+    return (size + kAlign - 1) / kAlign * kAlign;
+  }
+
+  const size_t block_size_;
+  std::mutex mu_;
+  Node* head_ = nullptr;
+};
+
+}}  // namespace triton::common
@@ -0,0 +1,160 @@
+// Copyright 2026, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace triton { namespace common {
+
+//
+// Move-only, type-erased 'void()' callable. Callables of up to
+// 'kInlineCapacity' bytes that are nothrow move constructible are stored
+// inline, larger ones are heap allocated. Unlike std::function it accepts
+// move-only callables, e.g. lambdas capturing a std::unique_ptr.
+//
+class InlineTask {
+ public:
+  static constexpr size_t kInlineCapacity = 64;
+
+  InlineTask() noexcept = default;
+
+  template <
+      typename F, typename D = typename std::decay<F>::type,
+      typename = typename std::enable_if<
+          !std::is_same<D, InlineTask>::value &&
+          std::is_invocable<D&>::value>::type>
+  InlineTask(F&& f)
+  {
+    // Preserve the emptiness of callables that have one, e.g. an empty
+    // std::function or a null function pointer.
+    if constexpr (std::is_constructible<bool, const D&>::value) {
+      if (!static_cast<bool>(f)) {
+        return;
+      }
+    }
+    if constexpr (IsInline<D>()) {
+      ::new (static_cast<void*>(&storage_)) D(std::forward<F>(f));
+      ops_ = &InlineModel<D>::kOps;
+    } else {
+      ::new (static_cast<void*>(&storage_)) D*(new D(std::forward<F>(f)));
+      ops_ = &HeapModel<D>::kOps;
+    }
+  }
+
+  InlineTask(InlineTask&& other) noexcept { MoveFrom(other); }
+
+  InlineTask& operator=(InlineTask&& other) noexcept
+  {
+    if (this != &other) {
+      Reset();
+      MoveFrom(other);
+    }
+    return *this;
+  }
+
+  InlineTask(const InlineTask&) = delete;
+  InlineTask& operator=(const InlineTask&) = delete;
+
+  ~InlineTask() { Reset(); }
+
+  explicit operator bool() const { return ops_ != nullptr; }
+
+  void operator()() { ops_->invoke(&storage_); }
+
+  // Whether the callable is stored without a heap allocation.
+  bool StoredInline() const { return (ops_ == nullptr) || ops_->is_inline; }
+
+  // Destroy the callable, leaving the task empty.
+  void Reset()
+  {
+    if (ops_ != nullptr) {
+      ops_->destroy(&storage_);
+      ops_ = nullptr;
+    }
+  }
+
+ private:
+  struct Ops {
+    void (*invoke)(void*);
+    // Move-construct the callable at 'dst' and destroy the one at 'src'.
+    void (*relocate)(void* dst, void* src) noexcept;
+    void (*destroy)(void*) noexcept;
+    bool is_inline;
+  };
+
+  template <typename D>
+  static constexpr bool IsInline()
+  {
+    return (sizeof(D) <= kInlineCapacity) &&
+           (alignof(D) <= alignof(std::max_align_t)) &&
+           std::is_nothrow_move_constructible<D>::value;
+  }
+
+  template <typename D>
+  struct InlineModel {
+    static void Invoke(void* storage) { (*static_cast<D*>(storage))(); }
+    static void Relocate(void* dst, void* src) noexcept
+    {
+      D* from = static_cast<D*>(src);
+      ::new (dst) D(std::move(*from));
+      from->~D();
+    }
+    static void Destroy(void* storage) noexcept
+    {
+      static_cast<D*>(storage)->~D();
+    }
+    static constexpr Ops kOps{&Invoke, &Relocate, &Destroy, true};
+  };
+
+  template <typename D>
+  struct HeapModel {
+    static D* Get(void* storage) { return *static_cast<D**>(storage); }
+    static void Invoke(void* storage) { (*Get(storage))(); }
+    static void Relocate(void* dst, void* src) noexcept
+    {
+      ::new (dst) D*(Get(src));
+    }
+    static void Destroy(void* storage) noexcept { delete Get(storage); }
+    static constexpr Ops kOps{&Invoke, &Relocate, &Destroy, false};
+  };
+
+  void MoveFrom(InlineTask& other) noexcept
+  {
+    if (other.ops_ != nullptr) {
+      other.ops_->relocate(&storage_, &other.storage_);
+      ops_ = other.ops_;
+      other.ops_ = nullptr;
+    }
+  }
+
+  const Ops* ops_ = nullptr;
+  alignas(std::max_align_t) unsigned char storage_[kInlineCapacity];
+};
+
+}}  // namespace triton::common
@@ -0,0 +1,251 @@
+// Copyright 2026, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "event_count.h"
+
+namespace triton { namespace common {
+
+//
+// Bounded, lock-free multi-producer multi-consumer queue with the same
+// Put / Get / Empty surface as SyncQueue. Based on Dmitry Vyukov's bounded
+// MPMC ring buffer: each slot carries a sequence number that tells
+// producers and consumers whether it is free or holds an item, so the
+// uncontended path is a single CAS on each side.
+//
+// Get() blocks while the queue is empty and Put() blocks while it is full.
+// Blocked callers spin for 'spin_count' attempts before parking on an
+// EventCount, and the other side only issues a wakeup system call when a
+// thread is actually parked.
+//
+template <typename Item>
+class LockFreeSyncQueue {
+ public:
+  // 'capacity' is rounded up to the next power of two.
+  explicit LockFreeSyncQueue(size_t capacity = 1024, size_t spin_count = 128)
+      : spin_count_(spin_count)
+  {
+    size_t rounded = 2;
+    while (rounded < capacity) {
+      rounded <<= 1;
+    }
+    mask_ = rounded - 1;
+    cells_.reset(new Cell[rounded]);
+    for (size_t i = 0; i < rounded; ++i) {
+      cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    enqueue_pos_.store(0, std::memory_order_relaxed);
+    dequeue_pos_.store(0, std::memory_order_relaxed);
+  }
+
+  ~LockFreeSyncQueue()
+  {
+    size_t pos;
+    while (Cell* cell = ClaimGet(&pos)) {
+      cell->Ptr()->~Item();
+    }
+  }
+
+  LockFreeSyncQueue(const LockFreeSyncQueue&) = delete;
+  LockFreeSyncQueue& operator=(const LockFreeSyncQueue&) = delete;
+
+  // Maximum number of items the queue can hold.
+  size_t Capacity() const { return mask_ + 1; }
+
+  // Whether the queue is empty. The result is a snapshot and may be stale
+  // by the time it is returned if other threads use the queue.
+  bool Empty()
+  {
+    return dequeue_pos_.load(std::memory_order_acquire) >=
+           enqueue_pos_.load(std::memory_order_acquire);
+  }
+
+  Item Get()
+  {
+    size_t pos;
+    Cell* cell = nullptr;
+    for (size_t spin = 0; (cell = ClaimGet(&pos)) == nullptr; ++spin) {
+      if (spin < spin_count_) {
+        CpuRelax();
+        continue;
+      }
+      not_empty_.PrepareWait();
+      if ((cell = ClaimGet(&pos)) != nullptr) {
+        not_empty_.CancelWait();
+        break;
+      }
+      not_empty_.Wait();
+    }
+    Item res(std::move(*cell->Ptr()));
+    ReleaseGet(cell, pos);
+    return res;
+  }
+
+  // Get an item if one is available, returns false if the queue is empty.
+  bool TryGet(Item* item)
+  {
+    size_t pos;
+    Cell* cell = ClaimGet(&pos);
+    if (cell == nullptr) {
+      return false;
+    }
+    *item = std::move(*cell->Ptr());
+    ReleaseGet(cell, pos);
+    return true;
+  }
+
+  void Put(const Item& value) { PutImpl(value); }
+
+  void Put(Item&& value) { PutImpl(std::move(value)); }
+
+  // Put an item if there is room, returns false if the queue is full.
+  bool TryPut(const Item& value) { return TryPutImpl(value); }
+
+  bool TryPut(Item&& value) { return TryPutImpl(std::move(value)); }
+
+ private:
+  struct Cell {
+    std::atomic<size_t> sequence;
+    typename std::aligned_storage<sizeof(Item), alignof(Item)>::type storage;
+
+    Item* Ptr() { return std::launder(reinterpret_cast<Item*>(&storage)); }
+  };
+
+  template <typename U>
+  void PutImpl(U&& value)
+  {
+    size_t pos;
+    Cell* cell = nullptr;
+    for (size_t spin = 0; (cell = ClaimPut(&pos)) == nullptr; ++spin) {
+      if (spin < spin_count_) {
+        CpuRelax();
+        continue;
+      }
+      not_full_.PrepareWait();
+      if ((cell = ClaimPut(&pos)) != nullptr) {
+        not_full_.CancelWait();
+        break;
+      }
+      not_full_.Wait();
+    }
+    ::new (&cell->storage) Item(std::forward<U>(value));
+    ReleasePut(cell, pos);
+  }
+
+  template <typename U>
+  bool TryPutImpl(U&& value)
+  {
+    size_t pos;
+    Cell* cell = ClaimPut(&pos);
+    if (cell == nullptr) {
+      return false;
+    }
+    ::new (&cell->storage) Item(std::forward<U>(value));
+    ReleasePut(cell, pos);
+    return true;
+  }
+
+  // Claim the next free slot for writing, returns nullptr if the queue is
+  // full.
+  Cell* ClaimPut(size_t* pos)
+  {
+    size_t p = enqueue_pos_.load(std::memory_order_relaxed);
+    while (true) {
+      Cell* cell = &cells_[p & mask_];
+      const size_t seq = cell->sequence.load(std::memory_order_acquire);
+      const intptr_t diff =
+          static_cast<intptr_t>(seq) - static_cast<intptr_t>(p);
+      if (diff == 0) {
+        if (enqueue_pos_.compare_exchange_weak(
+                p, p + 1, std::memory_order_relaxed)) {
+          *pos = p;
+          return cell;
+        }
+      } else if (diff < 0) {
+        return nullptr;
+      } else {
+        p = enqueue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  void ReleasePut(Cell* cell, size_t pos)
+  {
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    not_empty_.Notify();
+  }
+
+  // Claim the oldest item for reading, returns nullptr if the queue is
+  // empty.
+  Cell* ClaimGet(size_t* pos)
+  {
+    size_t p = dequeue_pos_.load(std::memory_order_relaxed);
+    while (true) {
+      Cell* cell = &cells_[p & mask_];
+      const size_t seq = cell->sequence.load(std::memory_order_acquire);
+      const intptr_t diff =
+          static_cast<intptr_t>(seq) - static_cast<intptr_t>(p + 1);
+      if (diff == 0) {
+        if (dequeue_pos_.compare_exchange_weak(
+                p, p + 1, std::memory_order_relaxed)) {
+          *pos = p;
+          return cell;
+        }
+      } else if (diff < 0) {
+        return nullptr;
+      } else {
+        p = dequeue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  void ReleaseGet(Cell* cell, size_t pos)
+  {
+    cell->Ptr()->~Item();
+    cell->sequence.store(pos + mask_ + 1, std::memory_order_release);
+    not_full_.Notify();
+  }
+
+  const size_t spin_count_;
+  size_t mask_;
+  std::unique_ptr<Cell[]> cells_;
+
+  // Producer and consumer positions are on separate cache lines to avoid
+  // false sharing between the two sides.
+  alignas(64) std::atomic<size_t> enqueue_pos_;
+  alignas(64) std::atomic<size_t> dequeue_pos_;
+  alignas(64) EventCount not_empty_;
+  alignas(64) EventCount not_full_;
+};
+
+}}  // namespace triton::common
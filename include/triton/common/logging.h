@@ -25,17 +25,25 @@
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #pragma once
 
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <cerrno>
+#include <chrono>
+#include <climits>
 #include <cstdint>
 #include <cstring>
 #include <fstream>
 #include <functional>
+#include <memory>
 #include <mutex>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
+#include "binary_log.h"
 #include "table_printer.h"
 #ifdef _WIN32
 // exclude winsock apis
@@ -50,6 +58,12 @@
 #include <unistd.h>
 #endif
 
+// Verbose logging levels above this one are compiled out, e.g. with
+// -DTRITON_LOG_MAX_VERBOSE=1 only LOG_VERBOSE(0) and LOG_VERBOSE(1) remain.
+#ifndef TRITON_LOG_MAX_VERBOSE
+#define TRITON_LOG_MAX_VERBOSE INT_MAX
+#endif
+
 
 namespace triton { namespace common {
 
@@ -57,8 +71,10 @@ namespace triton { namespace common {
 // Global logger for messages. Controls how log messages are reported.
 class Logger {
  public:
-  // Log Formats.
-  enum class Format { kDEFAULT, kISO8601 };
+  // Log Formats. kJSON writes each record as a single-line JSON object
+  // with the "level", "timestamp_us", "pid", "tid", "file", "line",
+  // "verbose", "heading" and "message" members.
+  enum class Format { kDEFAULT, kISO8601, kJSON };
 
   // Log levels.
   enum class Level : uint8_t { kERROR = 0, kWARNING = 1, kINFO = 2, kEND };
@@ -66,7 +82,16 @@ class Logger {
   inline static const std::array<const char*, static_cast<uint8_t>(Level::kEND)>
       LEVEL_NAMES{"E", "W", "I"};
 
+  // What Log() does in asynchronous mode when the ring of pending records
+  // is full: wait for the writer thread, or discard the oldest pending
+  // record or the new one. Discarded records are counted, see DroppedCount().
+  enum class OverflowPolicy { kBLOCK, kDROP_OLDEST, kDROP_NEWEST };
+
+  // Compression of the rotated log files, see SetLogRotation().
+  enum class Compression { kNONE, kGZIP, kZSTD };
+
   Logger();
+  ~Logger();
 
   // Is a log level enabled.
   bool IsEnabled(Level level) const
@@ -83,8 +108,68 @@ class Logger {
   // Get the current verbose logging level.
   uint32_t VerboseLevel() const { return vlevel_; }
 
+  // Get the verbose logging level of 'file', the level of the first verbose
+  // module pattern that matches it if any, else the current verbose logging
+  // level.
+  uint32_t VerboseLevel(const char* file);
+
   // Set the current verbose logging level.
-  void SetVerboseLevel(uint32_t vlevel) { vlevel_ = vlevel; }
+  void SetVerboseLevel(uint32_t vlevel)
+  {
+    vlevel_ = vlevel;
+    verbose_generation_++;
+  }
+
+  // Get the per-module verbose logging levels.
+  std::string VerboseModules();
+
+  // Set per-module verbose logging levels from a comma-separated list of
+  // 'pattern=level' entries, e.g. "dynamic_batch*=3,ensemble*=1". Patterns
+  // are matched against the file name without directory and extension and
+  // may use the '*' and '?' wildcards. An empty string clears them. Returns
+  // an empty string upon success, else returns an error string.
+  const std::string SetVerboseModules(const std::string& modules);
+
+  // Incremented whenever the verbose logging levels change, so that call
+  // sites can cache their level, see LogVerboseSite.
+  uint32_t VerboseGeneration() const
+  {
+    return verbose_generation_.load(std::memory_order_acquire);
+  }
+
+  // Limit each LOG_INFO, LOG_WARNING and LOG_ERROR call site to 'records'
+  // records per 'period', in bursts of up to 'records' records. The records
+  // beyond are dropped and counted in the next record of the call site.
+  // Zero 'records', the default, removes the limit.
+  void SetRateLimit(uint32_t records, std::chrono::nanoseconds period)
+  {
+    rate_burst_ = std::max<uint32_t>(records, 1);
+    rate_interval_ns_ = (records == 0)
+                            ? 0
+                            : std::max<int64_t>(period.count() / records, 1);
+  }
+
+  // Interval between the records of a call site allowed by the rate limit,
+  // 0 if there is none, and the number of records allowed at once.
+  int64_t RateLimitIntervalNs() const
+  {
+    return rate_interval_ns_.load(std::memory_order_relaxed);
+  }
+  uint32_t RateLimitBurst() const
+  {
+    return rate_burst_.load(std::memory_order_relaxed);
+  }
+
+  // Whether a LOG_INFO, LOG_WARNING or LOG_ERROR call site that logs the
+  // same message again drops the repeats, which are summarized by a "last
+  // message repeated N times" record once the call site logs a different
+  // message, or every 10 seconds of repeats. The repeats of a call site
+  // that then stops logging are never summarized. Disabled by default.
+  void SetSuppressRepeats(bool enable) { suppress_repeats_ = enable; }
+  bool SuppressRepeats() const
+  {
+    return suppress_repeats_.load(std::memory_order_relaxed);
+  }
 
   // Whether to escape log messages
   // using JSON string escaping rules.
@@ -105,6 +190,8 @@ class Logger {
     switch (format_) {
       case Format::kISO8601:
         return "ISO8601";
+      case Format::kJSON:
+        return "JSON";
       case Format::kDEFAULT:
         return "default";
       default:
@@ -120,27 +207,30 @@ class Logger {
 
   // Set the log output file. Returns an empty string upon
   // success, else returns an error string.
-  const std::string SetLogFile(const std::string& filename)
-  {
-    const std::lock_guard<std::mutex> lock(mutex_);
-    file_stream_.close();
-    std::string revert_name(filename_);
-    filename_ = filename;
-    if (!filename_.empty()) {
-      file_stream_.open(filename_, std::ios::app);
-      if (file_stream_.fail()) {
-        std::stringstream error;
-        error << __FILE__ << " " << __LINE__
-              << ": Failed to open log file: " << std::strerror(errno)
-              << std::endl;
-        filename_ = revert_name;
-        file_stream_.open(filename_, std::ios::app);
-        return error.str();
-      }
-    }
-    // will return an empty string
-    return std::string();
-  }
+  const std::string SetLogFile(const std::string& filename);
+
+  // Rotate the log file once it reaches 'max_size' bytes or 'interval'
+  // after the previous rotation, a zero value disables the trigger. The log
+  // file is renamed and a new one opened, the output is only locked to
+  // switch to it, then a background thread renames the rotated file to '<file>.1', after
+  // shifting the previous ones to '<file>.2' and so on, keeps 'max_files'
+  // of them and compresses it with 'compression'. Zero 'max_files'
+  // disables the rotation. Empty log files are not rotated and in
+  // asynchronous mode the size is checked after each batch of records.
+  // Returns an empty string upon success, else returns an error string.
+  // Not supported on Windows.
+  const std::string SetLogRotation(
+      uint64_t max_size, std::chrono::seconds interval, uint32_t max_files,
+      Compression compression = Compression::kNONE);
+
+  // Rotate the log file now. Returns an empty string upon success, else
+  // returns an error string.
+  const std::string RotateLogFile();
+
+  // Whether to rotate the log file when the process receives SIGHUP, with
+  // a handler that replaces the previous one until disabled. Returns an
+  // empty string upon success, else returns an error string.
+  const std::string SetRotateOnSighup(bool enable);
 
   // Delivers each enabled log record as structured fields to an embedding host
   // (e.g. Dynamo), bypassing Triton's default stderr/file sink entirely.
@@ -166,46 +256,367 @@ class Logger {
   }
   const LogCallbackFn& LogCallback() const { return callback_; }
 
+  // Write the log records to per-thread ring files in 'directory' instead of
+  // the output, see binary_log.h, to be rendered offline by
+  // triton-log-decode. LOG_VERBOSE_FMT records are written as the id of
+  // their call site and the raw values of their arguments, without
+  // formatting their message. Each thread maps a ring file of 'ring_size'
+  // bytes in which new records overwrite the oldest ones. An empty
+  // 'directory' disables the binary log. Records are delivered to the log
+  // callback instead while one is set. Returns an empty string upon
+  // success, else returns an error string. Not supported on Windows.
+  const std::string SetBinaryLog(
+      const std::string& directory, size_t ring_size = 16 << 20);
+  bool IsBinary() const
+  {
+    return (binary_session_.load(std::memory_order_relaxed) != 0) &&
+           !callback_;
+  }
+
+  // Write a record of call 'site' with 'count' 'values' to the ring file of
+  // the calling thread, at 'timestamp_ns' since the epoch, or now if 0.
+  // Returns false if the record is not written, e.g. if the ring file can
+  // not be created, for the caller to log it as text.
+  bool WriteBinary(
+      uint32_t site, const LogBinaryValue* values, size_t count,
+      uint64_t timestamp_ns = 0);
+
+  // Enable or disable the asynchronous mode. In asynchronous mode Log()
+  // only copies the record into a ring of 'capacity' preallocated records
+  // and a background thread writes them in batches, so that logging threads
+  // never wait for the output. 'policy' selects what happens when the ring
+  // is full. The records are written to the output file descriptors
+  // directly, bypassing std::cout and std::cerr. Disabling writes the
+  // pending records and stops the background thread. Returns an empty
+  // string upon success, else returns an error string.
+  //
+  // Like SetLogCallback(), this is not thread-safe and must not race with
+  // logging threads.
+  const std::string SetAsync(
+      bool enable, size_t capacity = 4096,
+      OverflowPolicy policy = OverflowPolicy::kBLOCK);
+  bool IsAsync() const { return async_writer_ != nullptr; }
+
+  // Number of records discarded by the asynchronous mode overflow policy.
+  uint64_t DroppedCount() const { return dropped_count_; }
+
   // Log a message.
   void Log(const std::string& msg, const Logger::Level level);
 
-  // Flush the log.
+  // Flush the log. In asynchronous mode, also waits until the records
+  // logged before the call have been written.
   void Flush();
 
  private:
+  class AsyncWriter;
+  class LogRotator;
+
+  // Rotate the log file if there is one and rotation is enabled, if it
+  // reached the rotation size only when 'if_full' is set. The file is
+  // renamed and reopened without 'mutex_' held, which must not be held by
+  // the caller, so that logging threads only wait for the swap of the
+  // streams. Returns an empty string upon success, else returns an error
+  // string and keeps writing to the current log file.
+  const std::string Rotate(bool if_full);
+
   inline static const char* ESCAPE_ENVIRONMENT_VARIABLE =
       "TRITON_SERVER_ESCAPE_LOG_MESSAGES";
   bool escape_log_messages_;
   std::array<bool, static_cast<uint8_t>(Level::kEND)> enables_;
   uint32_t vlevel_;
+  // Per-module verbose levels, see SetVerboseModules(). 'has_vmodules_' lets
+  // VerboseLevel(file) skip 'vmodule_mtx_' when there are none.
+  std::mutex vmodule_mtx_;
+  std::string vmodule_spec_;
+  std::vector<std::pair<std::string, uint32_t>> vmodules_;
+  std::atomic<bool> has_vmodules_{false};
+  // Starts at 1 so that a LogVerboseSite never matches before its first
+  // lookup.
+  std::atomic<uint32_t> verbose_generation_{1};
+  // See SetRateLimit() and SetSuppressRepeats().
+  std::atomic<int64_t> rate_interval_ns_{0};
+  std::atomic<uint32_t> rate_burst_{1};
+  std::atomic<bool> suppress_repeats_{false};
   Format format_;
+  // Serializes the rotations and the changes of the log file and rotation
+  // settings, see Rotate(). Taken before 'mutex_'.
+  std::mutex rotate_mtx_;
   std::mutex mutex_;
   std::string filename_;
   std::ofstream file_stream_;
+  // Incremented whenever 'file_stream_' is reopened.
+  uint64_t file_generation_ = 0;
+  // Size of the log file and size that triggers its rotation, 0 if none.
+  uint64_t file_size_ = 0;
+  uint64_t max_file_size_ = 0;
   LogCallbackFn callback_;
+  // Destroyed after 'async_writer_', which may rotate the log file.
+  std::unique_ptr<LogRotator> rotator_;
+  std::unique_ptr<AsyncWriter> async_writer_;
+  std::atomic<uint64_t> dropped_count_{0};
+  // See SetBinaryLog(), guarded by 'mutex_'. 'binary_session_' identifies
+  // the current binary log, 0 if none, so that threads map a new ring file
+  // when it changes.
+  std::string binary_directory_;
+  size_t binary_ring_size_ = 0;
+  uint32_t binary_sessions_ = 0;
+  std::atomic<uint32_t> binary_session_{0};
 };
 
 extern Logger gLogger_;
 
-// A log message.
+// Returns the part of 'path' after the last '/'. Evaluated at compile time
+// for the current file by TRITON_LOG_FILE.
+constexpr const char*
+LogBasename(const char* path)
+{
+  const char* basename = path;
+  for (const char* c = path; *c != '\0'; ++c) {
+    if (*c == '/') {
+      basename = c + 1;
+    }
+  }
+  return basename;
+}
+
+#define TRITON_LOG_FILE                        \
+  ([]() {                                      \
+    constexpr const char* basename__ =         \
+        triton::common::LogBasename(__FILE__); \
+    return basename__;                         \
+  }())
+
+// Verbose logging level of a call site, looked up by file with
+// Logger::VerboseLevel(file) and cached until the verbose logging levels
+// change. Instantiated as a function-local static by LOG_VERBOSE_IS_ON.
+class LogVerboseSite {
+ public:
+  explicit constexpr LogVerboseSite(const char* file) : file_(file), cached_(0)
+  {
+  }
+
+  uint32_t Level()
+  {
+    const uint32_t generation = gLogger_.VerboseGeneration();
+    const uint64_t cached = cached_.load(std::memory_order_relaxed);
+    if ((cached >> 32) == generation) {
+      return static_cast<uint32_t>(cached);
+    }
+    // A change during the lookup bumps the generation again, so a stale
+    // level is never cached for the new generation.
+    const uint32_t level = gLogger_.VerboseLevel(file_);
+    cached_.store(
+        (static_cast<uint64_t>(generation) << 32) | level,
+        std::memory_order_relaxed);
+    return level;
+  }
+
+ private:
+  const char* const file_;
+  // Generation in the high 32 bits, level in the low 32 bits.
+  std::atomic<uint64_t> cached_;
+};
+
+// State of a LOG_* call site, instantiated as a function-local static
+// which is constant-initialized so that it costs no guard: the token bucket
+// of its rate limit, its occurrence count and the hash of its last message.
+// The checks are single atomic operations on a coarse clock, so that
+// dropping a record costs a few nanoseconds.
+class LogSite {
+ public:
+  constexpr LogSite() = default;
+
+  // Whether the rate limit of the logger allows a record now, see
+  // Logger::SetRateLimit().
+  bool Allow()
+  {
+    const int64_t interval_ns = gLogger_.RateLimitIntervalNs();
+    return (interval_ns == 0) || Allow(interval_ns, gLogger_.RateLimitBurst());
+  }
+
+  // Whether a token bucket of 'burst' records, refilled with one record
+  // every 'interval_ns', allows a record now. Counts the dropped records.
+  bool Allow(int64_t interval_ns, uint32_t burst)
+  {
+    const int64_t now = NowNs();
+    const int64_t tolerance = (burst - 1) * interval_ns;
+    // Theoretical arrival time of the next record at the steady rate
+    int64_t next = next_ns_.load(std::memory_order_relaxed);
+    do {
+      if (now < next - tolerance) {
+        suppressed_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+      }
+    } while (!next_ns_.compare_exchange_weak(
+        next, std::max(next, now) + interval_ns, std::memory_order_relaxed));
+    return true;
+  }
+
+  // Whether this is the first of every 'n' occurrences of the call site,
+  // every occurrence if 'n' is 0 or 1.
+  bool EveryN(uint64_t n)
+  {
+    return (n <= 1) ||
+           ((count_.fetch_add(1, std::memory_order_relaxed) % n) == 0);
+  }
+
+  // Number of records dropped by Allow() since the previous call.
+  uint64_t TakeSuppressed()
+  {
+    return (suppressed_.load(std::memory_order_relaxed) == 0)
+               ? 0
+               : suppressed_.exchange(0, std::memory_order_relaxed);
+  }
+
+  // Whether the record with 'heading' and 'message' repeats the previous
+  // one of the call site and must be dropped. Sets 'repeats' to the number
+  // of repeats to summarize before, 0 if none. See
+  // Logger::SetSuppressRepeats().
+  bool SuppressRepeat(
+      const char* heading, const std::string& message, uint64_t* repeats);
+
+ private:
+  static constexpr int64_t kRepeatSummaryNs = 10000000000LL;
+
+  static int64_t NowNs()
+  {
+#ifdef CLOCK_MONOTONIC_COARSE
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &now);
+    return now.tv_sec * 1000000000LL + now.tv_nsec;
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+#endif
+  }
+
+  std::atomic<int64_t> next_ns_{0};
+  std::atomic<uint64_t> suppressed_{0};
+  std::atomic<uint64_t> count_{0};
+  std::atomic<uint64_t> last_hash_{0};
+  std::atomic<uint64_t> repeats_{0};
+  std::atomic<int64_t> repeats_since_ns_{0};
+};
+
+// Write 'format' up to its next "{}" placeholder to 'out', with "{{" and
+// "}}" written as single braces. Returns the text after the placeholder,
+// nullptr if there is none.
+inline const char*
+LogFormatText(std::ostream& out, const char* format)
+{
+  const char* text = format;
+  for (const char* c = format; *c != '\0'; ++c) {
+    if ((c[0] == '{') && (c[1] == '}')) {
+      out.write(text, c - text);
+      return c + 2;
+    }
+    if (((c[0] == '{') || (c[0] == '}')) && (c[1] == c[0])) {
+      out.write(text, c + 1 - text);
+      text = ++c + 1;
+    }
+  }
+  out.write(text, std::strlen(text));
+  return nullptr;
+}
+
+// Write 'format' to 'out', each "{}" placeholder replaced with the next of
+// 'args' as written by operator<<. Placeholders without an argument are
+// written as is and arguments without a placeholder are ignored. Used by
+// LOG_VERBOSE_FMT.
+inline void
+LogFormatTo(std::ostream& out, const char* format)
+{
+  while ((format = LogFormatText(out, format)) != nullptr) {
+    out << "{}";
+  }
+}
+
+template <typename Arg, typename... Args>
+void
+LogFormatTo(
+    std::ostream& out, const char* format, const Arg& arg,
+    const Args&... args)
+{
+  format = LogFormatText(out, format);
+  if (format != nullptr) {
+    out << arg;
+    LogFormatTo(out, format, args...);
+  }
+}
+
+// A LOG_VERBOSE_FMT call site, instantiated as a function-local static.
+// Registered with the binary log on its first record, which assigns it the
+// id its records are written with, see LogVerboseFormat().
+class LogFormatSite {
+ public:
+  constexpr LogFormatSite(const char* file, int line) : file_(file), line_(line)
+  {
+  }
+
+  // Id of the call site, whose records have 'format'.
+  uint32_t Id(const char* format)
+  {
+    const uint32_t id = id_.load(std::memory_order_acquire);
+    return (id != 0) ? id : Register(format);
+  }
+
+  const char* File() const { return file_; }
+  int Line() const { return line_; }
+
+ private:
+  uint32_t Register(const char* format);
+
+  const char* const file_;
+  const int line_;
+  std::atomic<uint32_t> id_{0};
+};
+
+// Fields of a log record, see LogFormatRecord().
+struct LogRecordFields {
+  Logger::Level level;
+  bool verbose;
+  // Microseconds since the epoch
+  uint64_t timestamp_us;
+  uint32_t pid;
+  uint64_t tid;
+  std::string_view file;
+  int line;
+  // nullptr if none
+  const char* heading;
+  std::string_view message;
+  // Whether the heading and the message are escaped, as JSON strings,
+  // outside of the JSON format which always escapes them.
+  bool escape_heading;
+  bool escape;
+};
+
+// Append the record 'fields' to 'record' in 'format', as the default sink
+// writes it. Also used by triton-log-decode to render the binary log.
+void LogFormatRecord(
+    std::string* record, Logger::Format format, const LogRecordFields& fields);
+
+// A log message. The message stream and the buffer the record is formatted
+// into are per-thread and reused, so that logging does not allocate once
+// they have grown to the size of the records.
 class LogMessage {
  public:
   LogMessage(
       const char* file, int line, Logger::Level level,
       const char* heading = nullptr,
       bool escape_log_messages = gLogger_.EscapeLogMessages())
-      : path_(file), line_(line), level_(level), pid_(GetProcessId()),
+      : path_(LogBasename(file)), line_(line), level_(level),
+        pid_(GetProcessId()), message_(AcquireStream(&owned_message_)),
         heading_(heading), escape_log_messages_(escape_log_messages)
   {
     SetTimestamp();
-    size_t path_start = path_.rfind('/');
-    if (path_start != std::string::npos) {
-      path_ = path_.substr(path_start + 1, std::string::npos);
-    }
   }
 
   ~LogMessage();
 
+  LogMessage(const LogMessage&) = delete;
+  LogMessage& operator=(const LogMessage&) = delete;
+
   // Marks this record as verbose so a structured callback can distinguish
   // LOG_VERBOSE from plain INFO. Has no effect on the default sink.
   LogMessage& SetVerbose()
@@ -214,15 +625,30 @@ class LogMessage {
     return *this;
   }
 
-  std::stringstream& stream() { return message_; }
+  // Applies the repeat suppression of 'site' to this record and reports
+  // the records it dropped, see LogSite.
+  LogMessage& SetSite(LogSite* site)
+  {
+    site_ = site;
+    return *this;
+  }
+
+  std::stringstream& stream() { return *message_; }
 
  private:
-  std::string path_;
+  // Returns the per-thread message stream, or a stream stored in 'owned' if
+  // the per-thread one is used by an enclosing message.
+  static std::stringstream* AcquireStream(
+      std::unique_ptr<std::stringstream>* owned);
+  void ReleaseStream();
+
+  const char* path_;
   const int line_;
   const Logger::Level level_;
   const uint32_t pid_;
-  void LogPreamble(std::stringstream& stream);
-  void LogTimestamp(std::stringstream& stream);
+  // Send a record to the callback or the default sink.
+  void Write(const char* heading, const std::string& message);
+  uint64_t TimestampMicros() const;
 
 #ifdef _WIN32
   SYSTEMTIME timestamp_;
@@ -236,12 +662,36 @@ class LogMessage {
   void SetTimestamp() { gettimeofday(&timestamp_, NULL); }
   static uint32_t GetProcessId() { return static_cast<uint32_t>(getpid()); };
 #endif
-  std::stringstream message_;
+  std::unique_ptr<std::stringstream> owned_message_;
+  std::stringstream* message_;
   const char* heading_;
   bool escape_log_messages_;
   bool is_verbose_ = false;
+  LogSite* site_ = nullptr;
 };
 
+// Log a LOG_VERBOSE_FMT record of 'site': the raw values of 'args' to the
+// binary log if enabled, else the message formatted by LogFormatTo().
+// 'format' is kept by the binary log and must be a string literal.
+template <typename... Args>
+void
+LogVerboseFormat(LogFormatSite& site, const char* format, const Args&... args)
+{
+  if (gLogger_.IsBinary()) {
+    // One more value, arrays can not be empty
+    const LogBinaryValue values[sizeof...(Args) + 1] = {
+        LogBinaryValue(args)...};
+    if (gLogger_.WriteBinary(site.Id(format), values, sizeof...(Args))) {
+      return;
+    }
+  }
+  LogFormatTo(
+      LogMessage(site.File(), site.Line(), Logger::Level::kINFO)
+          .SetVerbose()
+          .stream(),
+      format, args...);
+}
+
 #define LOG_ENABLE_INFO(E) \
   triton::common::gLogger_.SetEnabled(triton::common::Logger::Level::kINFO, (E))
 #define LOG_ENABLE_WARNING(E)          \
@@ -253,11 +703,16 @@ class LogMessage {
 #define LOG_SET_VERBOSE(L)                  \
   triton::common::gLogger_.SetVerboseLevel( \
       static_cast<uint32_t>(std::max(0, (L))))
+#define LOG_SET_VERBOSE_MODULES(M) \
+  triton::common::gLogger_.SetVerboseModules((M))
 #define LOG_SET_OUT_FILE(FN) triton::common::gLogger_.SetLogFile((FN))
 #define LOG_SET_FORMAT(F) triton::common::gLogger_.SetLogFormat((F))
 #define LOG_SET_CALLBACK(CB) triton::common::gLogger_.SetLogCallback((CB))
+#define LOG_SET_ASYNC(E) triton::common::gLogger_.SetAsync((E))
+#define LOG_ROTATE_FILE triton::common::gLogger_.RotateLogFile()
 
 #define LOG_VERBOSE_LEVEL triton::common::gLogger_.VerboseLevel()
+#define LOG_VERBOSE_MODULES triton::common::gLogger_.VerboseModules()
 #define LOG_FORMAT triton::common::gLogger_.LogFormat()
 #define LOG_FORMAT_STRING triton::common::gLogger_.LogFormatString()
 #define LOG_FILE triton::common::gLogger_.LogFile()
@@ -270,7 +725,18 @@ class LogMessage {
   triton::common::gLogger_.IsEnabled(triton::common::Logger::Level::kWARNING)
 #define LOG_ERROR_IS_ON \
   triton::common::gLogger_.IsEnabled(triton::common::Logger::Level::kERROR)
-#define LOG_VERBOSE_IS_ON(L) (triton::common::gLogger_.VerboseLevel() >= (L))
+// Checks the level of the call site, cached in a static. Constant levels
+// above TRITON_LOG_MAX_VERBOSE are compiled out.
+#define LOG_VERBOSE_IS_ON(L)                                        \
+  (((L) <= TRITON_LOG_MAX_VERBOSE) &&                               \
+   ([]() -> triton::common::LogVerboseSite& {                       \
+     static triton::common::LogVerboseSite site__(TRITON_LOG_FILE); \
+     return site__;                                                 \
+   }().Level() >= static_cast<uint32_t>(L)))
+// Checks the level of 'FN', which may differ between calls.
+#define LOG_VERBOSE_IS_ON_FL(L, FN)   \
+  (((L) <= TRITON_LOG_MAX_VERBOSE) && \
+   (triton::common::gLogger_.VerboseLevel((FN)) >= static_cast<uint32_t>(L)))
 
 #else
 
@@ -279,6 +745,7 @@ class LogMessage {
 #define LOG_WARNING_IS_ON false
 #define LOG_ERROR_IS_ON false
 #define LOG_VERBOSE_IS_ON(L) false
+#define LOG_VERBOSE_IS_ON_FL(L, FN) false
 
 #endif  // TRITON_ENABLE_LOGGING
 
@@ -299,17 +766,74 @@ class LogMessage {
       (char*)(FN), LN, triton::common::Logger::Level::kERROR) \
       .stream()
 #define LOG_VERBOSE_FL(L, FN, LN)                            \
-  if (LOG_VERBOSE_IS_ON(L))                                  \
+  if (LOG_VERBOSE_IS_ON_FL(L, FN))                           \
   triton::common::LogMessage(                                \
       (char*)(FN), LN, triton::common::Logger::Level::kINFO) \
       .SetVerbose()                                          \
       .stream()
 
-// Macros that use current filename and line number.
-#define LOG_INFO LOG_INFO_FL(__FILE__, __LINE__)
-#define LOG_WARNING LOG_WARNING_FL(__FILE__, __LINE__)
-#define LOG_ERROR LOG_ERROR_FL(__FILE__, __LINE__)
-#define LOG_VERBOSE(L) LOG_VERBOSE_FL(L, __FILE__, __LINE__)
+// The LogSite of the call site.
+#define LOG_SITE                           \
+  []() -> triton::common::LogSite& {       \
+    static triton::common::LogSite site__; \
+    return site__;                         \
+  }()
+
+// Logs at 'LEVEL' if 'IS_ON' and the call site allows it with 'ALLOW'.
+#define LOG_SITE_LEVEL(IS_ON, LEVEL, ALLOW)                            \
+  if (triton::common::LogSite& site__ = LOG_SITE; (IS_ON) && (ALLOW))  \
+  triton::common::LogMessage(                                          \
+      TRITON_LOG_FILE, __LINE__, triton::common::Logger::Level::LEVEL) \
+      .SetSite(&site__)                                                \
+      .stream()
+
+// Macros that use current filename and line number. LOG_INFO, LOG_WARNING
+// and LOG_ERROR are subject to the rate limit and the repeat suppression of
+// the logger.
+#define LOG_INFO LOG_SITE_LEVEL(LOG_INFO_IS_ON, kINFO, site__.Allow())
+#define LOG_WARNING LOG_SITE_LEVEL(LOG_WARNING_IS_ON, kWARNING, site__.Allow())
+#define LOG_ERROR LOG_SITE_LEVEL(LOG_ERROR_IS_ON, kERROR, site__.Allow())
+#define LOG_VERBOSE(L)                                                 \
+  if (LOG_VERBOSE_IS_ON(L))                                            \
+  triton::common::LogMessage(                                          \
+      TRITON_LOG_FILE, __LINE__, triton::common::Logger::Level::kINFO) \
+      .SetVerbose()                                                    \
+      .stream()
+// Same as LOG_VERBOSE(L) with the message formatted from a format string
+// literal and arguments, e.g. LOG_VERBOSE_FMT(2, "{} of {}", name,
+// version). The arguments are neither evaluated nor formatted unless the
+// record is logged, and the binary log stores them unformatted, see
+// LogVerboseFormat().
+#define LOG_VERBOSE_FMT(L, ...)                      \
+  if (LOG_VERBOSE_IS_ON(L))                          \
+  triton::common::LogVerboseFormat(                  \
+      []() -> triton::common::LogFormatSite& {       \
+        static triton::common::LogFormatSite site__( \
+            TRITON_LOG_FILE, __LINE__);              \
+        return site__;                               \
+      }(),                                           \
+      __VA_ARGS__)
+
+// Log the first of every 'N' occurrences of the call site, every
+// occurrence if 'N' is 0 or 1.
+#define LOG_INFO_EVERY_N(N) \
+  LOG_SITE_LEVEL(LOG_INFO_IS_ON, kINFO, site__.EveryN((N)))
+#define LOG_WARNING_EVERY_N(N) \
+  LOG_SITE_LEVEL(LOG_WARNING_IS_ON, kWARNING, site__.EveryN((N)))
+#define LOG_ERROR_EVERY_N(N) \
+  LOG_SITE_LEVEL(LOG_ERROR_IS_ON, kERROR, site__.EveryN((N)))
+
+// Log at most once every 'S' seconds from the call site, instead of the
+// rate limit of the logger. The next record logged reports the number of
+// records dropped.
+#define LOG_EVERY_SECONDS_ALLOW(S) \
+  site__.Allow(static_cast<int64_t>((S)*1e9), 1)
+#define LOG_INFO_EVERY_SECONDS(S) \
+  LOG_SITE_LEVEL(LOG_INFO_IS_ON, kINFO, LOG_EVERY_SECONDS_ALLOW(S))
+#define LOG_WARNING_EVERY_SECONDS(S) \
+  LOG_SITE_LEVEL(LOG_WARNING_IS_ON, kWARNING, LOG_EVERY_SECONDS_ALLOW(S))
+#define LOG_ERROR_EVERY_SECONDS(S) \
+  LOG_SITE_LEVEL(LOG_ERROR_IS_ON, kERROR, LOG_EVERY_SECONDS_ALLOW(S))
 
 // Macros for use with triton::common::table_printer objects
 //
@@ -0,0 +1,291 @@
+// Copyright 2026, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "event_count.h"
+#include "thread_pool.h"
+
+namespace triton { namespace common {
+
+namespace detail {
+
+//
+// State shared by the participants of one ParallelReduce call. Chunks are
+// claimed from 'next_' with guided sizes: a claim takes a share of the
+// remaining range that shrinks as the range drains, but never less than the
+// grain, so early claims are large and the tail is balanced finely.
+//
+// The state is referenced by the caller and by each helper task queued on
+// the pool, and freed by the last one to let go of it. The caller only
+// waits for the chunks that have been claimed, not for helper tasks that
+// have not started yet, and those never call the caller's functions.
+//
+template <typename Index, typename T, typename Map, typename Combine>
+class ParallelState {
+ public:
+  ParallelState(
+      Index begin, Index end, Index grain, uint32_t participants,
+      Map* map, Combine* combine)
+      : end_(end), grain_(grain), divisor_(Index(2) * participants),
+        total_(end - begin), map_(map), combine_(combine), next_(begin),
+        refs_(participants)
+  {
+  }
+
+  // Runs chunks until none is left and merges the result of those run.
+  void Participate()
+  {
+    Index chunk_begin, chunk_end;
+    if (!Claim(&chunk_begin, &chunk_end)) {
+      return;
+    }
+    Index done = 0;
+    std::optional<T> partial;
+    try {
+      do {
+        if (partial) {
+          partial.emplace((*combine_)(
+              std::move(*partial), (*map_)(chunk_begin, chunk_end)));
+        } else {
+          partial.emplace((*map_)(chunk_begin, chunk_end));
+        }
+        done += chunk_end - chunk_begin;
+      } while (Claim(&chunk_begin, &chunk_end));
+    }
+    catch (...) {
+      // Stop handing out chunks, the failed chunk and those never claimed
+      // count as done
+      done += (chunk_end - chunk_begin) + (end_ - next_.exchange(end_));
+      std::lock_guard<std::mutex> lk(mtx_);
+      if (!exception_) {
+        exception_ = std::current_exception();
+      }
+    }
+    Merge(std::move(partial), done);
+  }
+
+  // Waits for all claimed chunks to finish, returns the merged result, if
+  // any chunk ran, or rethrows the first exception.
+  std::optional<T> Wait()
+  {
+    while (done_.load(std::memory_order_acquire) != total_) {
+      done_ec_.PrepareWait();
+      if (done_.load(std::memory_order_acquire) == total_) {
+        done_ec_.CancelWait();
+        break;
+      }
+      done_ec_.Wait();
+    }
+    std::lock_guard<std::mutex> lk(mtx_);
+    if (exception_) {
+      std::rethrow_exception(exception_);
+    }
+    return std::move(result_);
+  }
+
+  void Release()
+  {
+    if (refs_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      delete this;
+    }
+  }
+
+ private:
+  bool Claim(Index* chunk_begin, Index* chunk_end)
+  {
+    Index current = next_.load(std::memory_order_relaxed);
+    while (current < end_) {
+      const Index remaining = end_ - current;
+      const Index size =
+          std::min(remaining, std::max(grain_, remaining / divisor_));
+      if (next_.compare_exchange_weak(
+              current, current + size, std::memory_order_relaxed)) {
+        *chunk_begin = current;
+        *chunk_end = current + size;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void Merge(std::optional<T>&& partial, Index done)
+  {
+    {
+      std::lock_guard<std::mutex> lk(mtx_);
+      if (partial && !exception_) {
+        try {
+          if (result_) {
+            result_.emplace(
+                (*combine_)(std::move(*result_), std::move(*partial)));
+          } else {
+            result_.emplace(std::move(*partial));
+          }
+        }
+        catch (...) {
+          exception_ = std::current_exception();
+        }
+      }
+    }
+    // Account for the work only once its result is merged, the caller may
+    // return as soon as all work is accounted for.
+    if (done_.fetch_add(done, std::memory_order_acq_rel) + done == total_) {
+      done_ec_.NotifyAll();
+    }
+  }
+
+  const Index end_;
+  const Index grain_;
+  const Index divisor_;
+  const Index total_;
+  Map* const map_;
+  Combine* const combine_;
+
+  std::atomic<Index> next_;
+  std::atomic<Index> done_{0};
+  EventCount done_ec_;
+  std::atomic<uint32_t> refs_;
+
+  std::mutex mtx_;
+  std::optional<T> result_;
+  std::exception_ptr exception_;
+};
+
+// Pool task running one helper of a ParallelReduce call. Destroyed without
+// running, e.g. because the pool rejected or discarded it, it only drops
+// its reference.
+template <typename State>
+class ParallelHelper {
+ public:
+  explicit ParallelHelper(State* state) : state_(state) {}
+  ParallelHelper(ParallelHelper&& other) noexcept : state_(other.state_)
+  {
+    other.state_ = nullptr;
+  }
+  ParallelHelper& operator=(ParallelHelper&&) = delete;
+  ~ParallelHelper()
+  {
+    if (state_ != nullptr) {
+      state_->Release();
+    }
+  }
+
+  void operator()()
+  {
+    state_->Participate();
+    state_->Release();
+    state_ = nullptr;
+  }
+
+ private:
+  State* state_;
+};
+
+}  // namespace detail
+
+//
+// Splits [begin, end) into chunks of at least 'grain' indices, computes
+// 'map(chunk_begin, chunk_end)' for each chunk on 'pool' and returns the
+// results folded with 'combine' onto 'identity'. 'combine' must be
+// associative and commutative as chunks complete in any order.
+//
+// The calling thread runs chunks too, so the call completes even when the
+// pool is busy or the caller is one of its workers, and it returns once
+// all chunks are done. Chunk sizes adapt to the remaining work and tasks
+// are queued per helper thread, not per chunk, so a call allocates once
+// whatever the number of chunks. Exceptions thrown by 'map' or 'combine'
+// stop the remaining chunks from starting and the first one is rethrown.
+//
+template <typename Index, typename T, typename Map, typename Combine>
+T
+ParallelReduce(
+    ThreadPool* pool, Index begin, Index end, Index grain, T identity,
+    Map&& map, Combine&& combine)
+{
+  static_assert(
+      std::is_integral<Index>::value, "ParallelReduce requires integral index");
+  if (end <= begin) {
+    return identity;
+  }
+  grain = std::max(grain, Index(1));
+  const Index chunks = (end - begin - 1) / grain + 1;
+  const size_t helpers = (pool == nullptr)
+                             ? 0
+                             : std::min(pool->Size(), size_t(chunks - 1));
+  if (helpers == 0) {
+    return combine(std::move(identity), map(begin, end));
+  }
+
+  using MapFn = typename std::remove_reference<Map>::type;
+  using CombineFn = typename std::remove_reference<Combine>::type;
+  using State = detail::ParallelState<Index, T, MapFn, CombineFn>;
+  State* state =
+      new State(begin, end, grain, helpers + 1, &map, &combine);
+  for (size_t i = 0; i < helpers; ++i) {
+    pool->Enqueue(detail::ParallelHelper<State>(state));
+  }
+  state->Participate();
+  std::optional<T> result;
+  try {
+    result = state->Wait();
+  }
+  catch (...) {
+    state->Release();
+    throw;
+  }
+  state->Release();
+  if (!result) {
+    return identity;
+  }
+  return combine(std::move(identity), std::move(*result));
+}
+
+//
+// Calls 'fn(chunk_begin, chunk_end)' for chunks of at least 'grain'
+// indices covering [begin, end) on 'pool', see ParallelReduce.
+//
+template <typename Index, typename Fn>
+void
+ParallelFor(ThreadPool* pool, Index begin, Index end, Index grain, Fn&& fn)
+{
+  struct Empty {};
+  ParallelReduce(
+      pool, begin, end, grain, Empty(),
+      [&fn](Index chunk_begin, Index chunk_end) {
+        fn(chunk_begin, chunk_end);
+        return Empty();
+      },
+      [](Empty, Empty) { return Empty(); });
+}
+
+}}  // namespace triton::common
@@ -0,0 +1,284 @@
+// Copyright 2026, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "thread_pool.h"
+
+namespace triton { namespace common {
+
+//
+// Runs tasks posted with the same key one at a time and in posting order,
+// while tasks of different keys run in parallel on a ThreadPool, e.g. the
+// requests of one sequence of a sequence batching model keyed by their
+// correlation ID.
+//
+// Each active key is a strand with a lock-free multi-producer queue. The
+// first task posted to an idle strand schedules a drain on the pool, which
+// runs the strand's tasks until it is empty, so no pool worker ever waits
+// for a key to become available. A drain yields its worker after
+// 'max_tasks_per_run' tasks by re-queueing itself behind the pool's other
+// work. Idle strands are removed so keys cost nothing once their tasks
+// are done.
+//
+// Once the pool is shut down, tasks that have not started may be
+// destroyed without running.
+//
+template <typename Key, typename Hash = std::hash<Key>>
+class StrandExecutor {
+ public:
+  using Task = ThreadPool::Task;
+
+  explicit StrandExecutor(ThreadPool* pool, size_t max_tasks_per_run = 64)
+      : pool_(pool), max_tasks_per_run_(max_tasks_per_run), shards_(kShards)
+  {
+  }
+
+  // Waits for the posted tasks to finish.
+  ~StrandExecutor()
+  {
+    std::unique_lock<std::mutex> lk(idle_mtx_);
+    idle_cv_.wait(lk, [this]() { return strand_count_.load() == 0; });
+  }
+
+  StrandExecutor(const StrandExecutor&) = delete;
+  StrandExecutor& operator=(const StrandExecutor&) = delete;
+
+  // Queues 'task' to run after the tasks previously posted with 'key'.
+  // Returns false if the task was rejected because the pool is shut down.
+  bool Post(const Key& key, Task&& task)
+  {
+    Node* node = new Node(std::move(task));
+    Shard& shard = shards_[hash_(key) % kShards];
+    Strand* strand;
+    bool schedule;
+    {
+      std::lock_guard<std::mutex> lk(shard.mu_);
+      auto& entry = shard.strands_[key];
+      if (!entry) {
+        entry.reset(new Strand(key, &shard));
+        strand_count_.fetch_add(1);
+      }
+      strand = entry.get();
+      // Counting the task while holding the shard lock ensures the strand
+      // is not removed by a drain that just became idle.
+      schedule = (strand->pending_.fetch_add(1) == 0);
+      strand->Push(node);
+    }
+    if (schedule) {
+      // If rejected, the drain's destructor discards the strand's tasks
+      return pool_->Enqueue(Drain(this, strand));
+    }
+    return true;
+  }
+
+  // Returns the number of keys with queued or running tasks.
+  size_t ActiveStrands() const { return strand_count_.load(); }
+
+ private:
+  static constexpr size_t kShards = 16;
+
+  struct Node {
+    explicit Node(Task&& task) : task_(std::move(task)) {}
+    Task task_;
+    std::atomic<Node*> next_{nullptr};
+  };
+
+  struct Shard;
+
+  // Intrusive multi-producer single-consumer queue after Dmitry Vyukov's
+  // design. Producers only exchange the tail, the drain owning the strand
+  // is the single consumer.
+  struct Strand {
+    Strand(const Key& key, Shard* shard)
+        : key_(key), shard_(shard), head_(&stub_), tail_(&stub_)
+    {
+    }
+
+    void Push(Node* node)
+    {
+      node->next_.store(nullptr, std::memory_order_relaxed);
+      Node* prev = tail_.exchange(node, std::memory_order_acq_rel);
+      prev->next_.store(node, std::memory_order_release);
+    }
+
+    // Returns nullptr if the queue is empty or a producer is between its
+    // exchange and its link, in which case the caller retries.
+    Node* Pop()
+    {
+      Node* head = head_;
+      Node* next = head->next_.load(std::memory_order_acquire);
+      if (head == &stub_) {
+        if (next == nullptr) {
+          return nullptr;
+        }
+        head_ = next;
+        head = next;
+        next = next->next_.load(std::memory_order_acquire);
+      }
+      if (next != nullptr) {
+        head_ = next;
+        return head;
+      }
+      if (head != tail_.load(std::memory_order_acquire)) {
+        return nullptr;
+      }
+      Push(&stub_);
+      next = head->next_.load(std::memory_order_acquire);
+      if (next != nullptr) {
+        head_ = next;
+        return head;
+      }
+      return nullptr;
+    }
+
+    const Key key_;
+    Shard* const shard_;
+    // Number of posted tasks that have not finished. The post that moves
+    // it from 0 schedules the drain.
+    std::atomic<size_t> pending_{0};
+    Node stub_{Task()};
+    // Consumer side
+    Node* head_;
+    // Producer side, on its own cache line
+    alignas(64) std::atomic<Node*> tail_;
+  };
+
+  struct Shard {
+    std::mutex mu_;
+    std::unordered_map<Key, std::unique_ptr<Strand>, Hash> strands_;
+  };
+
+  // Pool task draining one strand. Destroyed without running, e.g. because
+  // the pool rejected or discarded it, it discards the strand's tasks so
+  // that the strand does not stay active forever.
+  class Drain {
+   public:
+    Drain(StrandExecutor* executor, Strand* strand)
+        : executor_(executor), strand_(strand)
+    {
+    }
+    Drain(Drain&& other) noexcept
+        : executor_(other.executor_), strand_(other.strand_)
+    {
+      other.strand_ = nullptr;
+    }
+    Drain& operator=(Drain&&) = delete;
+    ~Drain()
+    {
+      if (strand_ != nullptr) {
+        executor_->Run(strand_, false /* execute */);
+      }
+    }
+
+    void operator()()
+    {
+      Strand* strand = strand_;
+      strand_ = nullptr;
+      executor_->Run(strand, true /* execute */);
+    }
+
+   private:
+    StrandExecutor* executor_;
+    Strand* strand_;
+  };
+
+  // Runs, or discards if not 'execute', the tasks of 'strand' until it is
+  // idle. Only one Run() per strand is active at any time.
+  void Run(Strand* strand, bool execute)
+  {
+    for (size_t count = 0;; ++count) {
+      if (execute && (count == max_tasks_per_run_)) {
+        // Give the worker back to the other work, the strand continues
+        // from the pool's queue.
+        pool_->Enqueue(Drain(this, strand));
+        return;
+      }
+      Node* node = strand->Pop();
+      while (node == nullptr) {
+        // 'pending_' guarantees a task is being pushed
+        std::this_thread::yield();
+        node = strand->Pop();
+      }
+      if (execute && node->task_) {
+        node->task_();
+      }
+      delete node;
+      if (Finish(strand)) {
+        return;
+      }
+    }
+  }
+
+  // Accounts for a finished task of 'strand', removing the strand and
+  // returning true if it has become idle. Only the strand's drain lowers
+  // 'pending_', so if it is above one it cannot reach zero here and the
+  // shard lock, which posts hold while raising it, is only taken for the
+  // last task.
+  bool Finish(Strand* strand)
+  {
+    if (strand->pending_.load() > 1) {
+      strand->pending_.fetch_sub(1);
+      return false;
+    }
+    Shard& shard = *strand->shard_;
+    {
+      std::lock_guard<std::mutex> lk(shard.mu_);
+      if (strand->pending_.fetch_sub(1) != 1) {
+        return false;
+      }
+      shard.strands_.erase(strand->key_);
+    }
+    {
+      // Lowered and notified under the lock, so that the destructor does
+      // not see the executor idle and destroy it before the notification
+      std::lock_guard<std::mutex> lk(idle_mtx_);
+      if (strand_count_.fetch_sub(1) == 1) {
+        idle_cv_.notify_all();
+      }
+    }
+    return true;
+  }
+
+  ThreadPool* pool_;
+  const size_t max_tasks_per_run_;
+  Hash hash_;
+  std::vector<Shard> shards_;
+  std::atomic<size_t> strand_count_{0};
+  std::mutex idle_mtx_;
+  std::condition_variable idle_cv_;
+};
+
+}}  // namespace triton::common
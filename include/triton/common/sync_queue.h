@@ -1,4 +1,4 @@
-// Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+// Copyright 2020-2026, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Redistribution and use in source and binary forms, with or without
 // modification, are permitted provided that the following conditions
@@ -25,19 +25,53 @@
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #pragma once
 
+#include <algorithm>
+#include <chrono>
 #include <condition_variable>
 #include <deque>
+#include <iterator>
 #include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
 
 namespace triton { namespace common {
 
 //
 // C++11 doesn't have a sync queue so we implement a simple one.
 //
+// The queue is unbounded by default. If constructed with a non-zero
+// 'capacity' Put() blocks while the queue is full, which provides
+// backpressure from consumers to producers. TryPut() / PutFor() /
+// PutUntil() and TryGet() / GetFor() / GetUntil() let callers shed load
+// instead of blocking indefinitely.
+//
+// GetBatch() and PutBatch() move runs of items under a single lock
+// acquisition, for consumers that process items in batches.
+//
+// Close() wakes all waiters. Once closed, puts are rejected and gets
+// return the remaining items until the queue is drained, after which
+// Get(Item*) and the try / timed gets return false. Get() blocks until an
+// item arrives, consumers of a queue that may be closed use Get(Item*).
+//
+// GetOrWait() registers a waiter that is handed the next item instead of
+// blocking a thread, which backs 'co_await AsyncGet(queue)', see
+// coroutine.h.
+//
 template <typename Item>
 class SyncQueue {
  public:
-  SyncQueue() {}
+  explicit SyncQueue(size_t capacity = 0) : capacity_(capacity) {}
+
+  // Waiter for an item that does not block a thread, see GetOrWait().
+  struct AsyncWaiter {
+    // Called, without the queue lock held, once 'item' is set or the queue
+    // is closed.
+    void (*notify)(AsyncWaiter*) = nullptr;
+    // Empty if the queue was closed and drained
+    std::optional<Item> item;
+    AsyncWaiter* next = nullptr;
+  };
 
   bool Empty()
   {
@@ -45,39 +79,354 @@ class SyncQueue {
     return queue_.empty();
   }
 
+  size_t Size()
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    return queue_.size();
+  }
+
+  // Maximum number of items, 0 if the queue is unbounded.
+  size_t Capacity() const { return capacity_; }
+
+  bool IsClosed()
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    return closed_;
+  }
+
+  // Reject further puts and wake all blocked callers.
+  void Close()
+  {
+    AsyncWaiter* waiters;
+    {
+      std::lock_guard<std::mutex> lk(mu_);
+      closed_ = true;
+      waiters = waiters_head_;
+      waiters_head_ = nullptr;
+      waiters_tail_ = nullptr;
+    }
+    not_empty_cv_.notify_all();
+    not_full_cv_.notify_all();
+    NotifyAsyncWaiters(waiters);
+  }
+
+  // Block until an item is available.
   Item Get()
   {
     std::unique_lock<std::mutex> lk(mu_);
     if (queue_.empty()) {
-      cv_.wait(lk, [this] { return !queue_.empty(); });
+      not_empty_cv_.wait(lk, [this] { return !queue_.empty(); });
+    }
+    return PopLocked(lk);
+  }
+
+  // Block until an item is available and move it to 'item'. Returns false
+  // if the queue is closed and drained.
+  bool Get(Item* item)
+  {
+    std::unique_lock<std::mutex> lk(mu_);
+    if (queue_.empty()) {
+      not_empty_cv_.wait(lk, [this] { return !queue_.empty() || closed_; });
+      if (queue_.empty()) {
+        return false;
+      }
+    }
+    *item = PopLocked(lk);
+    return true;
+  }
+
+  // Take an item into 'waiter' if one is available or report the queue as
+  // closed and drained, and return true. Otherwise return false and hand
+  // the next item put to 'waiter' by calling its 'notify', which must keep
+  // 'waiter' alive until then. Waiters are served in order, before
+  // callers blocked in Get().
+  bool GetOrWait(AsyncWaiter* waiter)
+  {
+    std::unique_lock<std::mutex> lk(mu_);
+    if (queue_.empty()) {
+      if (!closed_) {
+        waiter->next = nullptr;
+        if (waiters_tail_ == nullptr) {
+          waiters_head_ = waiter;
+        } else {
+          waiters_tail_->next = waiter;
+        }
+        waiters_tail_ = waiter;
+        return false;
+      }
+      waiter->item.reset();
+      return true;
+    }
+    waiter->item = PopLocked(lk);
+    return true;
+  }
+
+  // Get an item if one is available without blocking. Returns false if the
+  // queue is empty.
+  bool TryGet(Item* item)
+  {
+    std::unique_lock<std::mutex> lk(mu_);
+    if (queue_.empty()) {
+      return false;
+    }
+    *item = PopLocked(lk);
+    return true;
+  }
+
+  // Wait at most 'timeout' for an item. Returns false on timeout or if the
+  // queue is closed and drained.
+  template <typename Rep, typename Period>
+  bool GetFor(const std::chrono::duration<Rep, Period>& timeout, Item* item)
+  {
+    return GetUntil(std::chrono::steady_clock::now() + timeout, item);
+  }
+
+  // Wait until 'deadline' for an item. Returns false on timeout or if the
+  // queue is closed and drained.
+  template <typename Clock, typename Duration>
+  bool GetUntil(
+      const std::chrono::time_point<Clock, Duration>& deadline, Item* item)
+  {
+    std::unique_lock<std::mutex> lk(mu_);
+    if (!not_empty_cv_.wait_until(
+            lk, deadline, [this] { return !queue_.empty() || closed_; }) ||
+        queue_.empty()) {
+      return false;
     }
+    *item = PopLocked(lk);
+    return true;
+  }
+
+  // Wait at most 'timeout' for the first item, then move up to 'max_items'
+  // available items to the end of 'items' without waiting further. Returns
+  // the number of items moved, 0 on timeout or if the queue is closed and
+  // drained.
+  template <typename Rep, typename Period>
+  size_t GetBatch(
+      size_t max_items, const std::chrono::duration<Rep, Period>& timeout,
+      std::vector<Item>* items)
+  {
+    size_t count = 0;
+    {
+      std::unique_lock<std::mutex> lk(mu_);
+      if (!not_empty_cv_.wait_for(
+              lk, timeout, [this] { return !queue_.empty() || closed_; })) {
+        return 0;
+      }
+      count = std::min(max_items, queue_.size());
+      items->reserve(items->size() + count);
+      for (size_t i = 0; i < count; ++i) {
+        items->emplace_back(std::move(queue_.front()));
+        queue_.pop_front();
+      }
+    }
+    if ((capacity_ != 0) && (count != 0)) {
+      NotifyWaiters(not_full_cv_, count);
+    }
+    return count;
+  }
+
+  // Move all items of 'range' to the queue, blocking while the queue is
+  // full. Items are added in runs under a single lock acquisition, as many
+  // as there is room for. Returns the number of items added, which is less
+  // than the size of 'range' only if the queue is closed.
+  template <typename Range>
+  size_t PutBatch(Range&& range)
+  {
+    auto it = std::begin(range);
+    const auto end = std::end(range);
+    size_t count = 0;
+    while (it != end) {
+      size_t added = 0;
+      size_t handed = 0;
+      AsyncWaiter* waiters = nullptr;
+      {
+        std::unique_lock<std::mutex> lk(mu_);
+        if (Full()) {
+          not_full_cv_.wait(lk, [this] { return !Full() || closed_; });
+        }
+        if (closed_) {
+          break;
+        }
+        if (waiters_head_ != nullptr) {
+          waiters = waiters_head_;
+          AsyncWaiter* last = nullptr;
+          for (; (it != end) && (waiters_head_ != nullptr); ++it, ++handed) {
+            last = waiters_head_;
+            last->item = std::move(*it);
+            waiters_head_ = last->next;
+          }
+          last->next = nullptr;
+          if (waiters_head_ == nullptr) {
+            waiters_tail_ = nullptr;
+          }
+        }
+        for (; (it != end) && !Full(); ++it, ++added) {
+          queue_.push_back(std::move(*it));
+        }
+      }
+      NotifyAsyncWaiters(waiters);
+      NotifyWaiters(not_empty_cv_, added);
+      count += handed + added;
+    }
+    return count;
+  }
+
+  // Block while the queue is full. Returns false, without taking 'value',
+  // if the queue is closed.
+  bool Put(const Item& value) { return PutImpl(value); }
+
+  bool Put(Item&& value) { return PutImpl(std::move(value)); }
+
+  // Put 'value' only if there is room. Returns false if the queue is full or
+  // closed.
+  bool TryPut(const Item& value) { return TryPutImpl(value); }
+
+  bool TryPut(Item&& value) { return TryPutImpl(std::move(value)); }
+
+  // Wait at most 'timeout' for room to put 'value'. Returns false on timeout
+  // or if the queue is closed.
+  template <typename Rep, typename Period>
+  bool PutFor(const std::chrono::duration<Rep, Period>& timeout, Item&& value)
+  {
+    return PutUntilImpl(
+        std::move(value), std::chrono::steady_clock::now() + timeout);
+  }
+
+  // Wait until 'deadline' for room to put 'value'. Returns false on timeout
+  // or if the queue is closed.
+  template <typename Clock, typename Duration>
+  bool PutUntil(
+      const std::chrono::time_point<Clock, Duration>& deadline, Item&& value)
+  {
+    return PutUntilImpl(std::move(value), deadline);
+  }
+
+ private:
+  static void NotifyWaiters(std::condition_variable& cv, size_t count)
+  {
+    if (count == 1) {
+      cv.notify_one();
+    } else if (count > 1) {
+      cv.notify_all();
+    }
+  }
+
+  bool Full() const { return (capacity_ != 0) && (queue_.size() >= capacity_); }
+
+  // Hands 'value' to the first async waiter, if any, and returns it.
+  template <typename U>
+  AsyncWaiter* HandOffLocked(U&& value)
+  {
+    AsyncWaiter* waiter = waiters_head_;
+    if (waiter != nullptr) {
+      waiters_head_ = waiter->next;
+      if (waiters_head_ == nullptr) {
+        waiters_tail_ = nullptr;
+      }
+      waiter->next = nullptr;
+      waiter->item = std::forward<U>(value);
+    }
+    return waiter;
+  }
+
+  // Notifies the list of waiters starting at 'waiter'.
+  static void NotifyAsyncWaiters(AsyncWaiter* waiter)
+  {
+    while (waiter != nullptr) {
+      // The waiter may be gone once notified
+      AsyncWaiter* next = waiter->next;
+      waiter->notify(waiter);
+      waiter = next;
+    }
+  }
+
+  Item PopLocked(std::unique_lock<std::mutex>& lk)
+  {
     auto res = std::move(queue_.front());
     queue_.pop_front();
+    const bool notify = (capacity_ != 0);
+    lk.unlock();
+    // Only one slot was freed so only one blocked producer can make progress
+    if (notify) {
+      not_full_cv_.notify_one();
+    }
     return res;
   }
 
-  void Put(const Item& value)
+  template <typename U>
+  bool PutImpl(U&& value)
   {
     {
-      std::lock_guard<std::mutex> lk(mu_);
-      queue_.push_back(value);
+      std::unique_lock<std::mutex> lk(mu_);
+      if (Full()) {
+        not_full_cv_.wait(lk, [this] { return !Full() || closed_; });
+      }
+      if (closed_) {
+        return false;
+      }
+      if (AsyncWaiter* waiter = HandOffLocked(std::forward<U>(value))) {
+        lk.unlock();
+        NotifyAsyncWaiters(waiter);
+        return true;
+      }
+      queue_.push_back(std::forward<U>(value));
     }
-    cv_.notify_all();
+    // Only one item was added so only one waiting consumer can make progress
+    not_empty_cv_.notify_one();
+    return true;
   }
 
-  void Put(Item&& value)
+  template <typename U>
+  bool TryPutImpl(U&& value)
   {
     {
-      std::lock_guard<std::mutex> lk(mu_);
-      queue_.push_back(std::move(value));
+      std::unique_lock<std::mutex> lk(mu_);
+      if (Full() || closed_) {
+        return false;
+      }
+      if (AsyncWaiter* waiter = HandOffLocked(std::forward<U>(value))) {
+        lk.unlock();
+        NotifyAsyncWaiters(waiter);
+        return true;
+      }
+      queue_.push_back(std::forward<U>(value));
     }
-    cv_.notify_all();
+    not_empty_cv_.notify_one();
+    return true;
   }
 
- private:
+  template <typename U, typename Clock, typename Duration>
+  bool PutUntilImpl(
+      U&& value, const std::chrono::time_point<Clock, Duration>& deadline)
+  {
+    {
+      std::unique_lock<std::mutex> lk(mu_);
+      if (!not_full_cv_.wait_until(
+              lk, deadline, [this] { return !Full() || closed_; }) ||
+          closed_) {
+        return false;
+      }
+      if (AsyncWaiter* waiter = HandOffLocked(std::forward<U>(value))) {
+        lk.unlock();
+        NotifyAsyncWaiters(waiter);
+        return true;
+      }
+      queue_.push_back(std::forward<U>(value));
+    }
+    not_empty_cv_.notify_one();
+    return true;
+  }
+
+  const size_t capacity_;
+  bool closed_ = false;
   std::mutex mu_;
-  std::condition_variable cv_;
+  std::condition_variable not_empty_cv_;
+  std::condition_variable not_full_cv_;
   std::deque<Item> queue_;
+  // Async waiters in arrival order, only present while 'queue_' is empty
+  AsyncWaiter* waiters_head_ = nullptr;
+  AsyncWaiter* waiters_tail_ = nullptr;
 };
 
 }}  // namespace triton::common
@@ -0,0 +1,251 @@
+// Copyright 2026, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include <atomic>
+#include <exception>
+#include <future>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "event_count.h"
+#include "free_list.h"
+
+namespace triton { namespace common {
+
+//
+// Lightweight one-shot future / promise pair used by ThreadPool::Submit.
+// The shared state is allocated from a FreeList when it fits in a block,
+// and waiting uses an EventCount so setting the value only makes a system
+// call if a thread is blocked in Wait() or Get().
+//
+template <typename T>
+class TaskState {
+ public:
+  static TaskState* Create(const std::shared_ptr<FreeList>& blocks)
+  {
+    if (blocks && (sizeof(TaskState) <= blocks->BlockSize())) {
+      return ::new (blocks->Allocate()) TaskState(blocks);
+    }
+    return new TaskState(nullptr);
+  }
+
+  void Release()
+  {
+    if (refs_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      if (blocks_) {
+        std::shared_ptr<FreeList> blocks = std::move(blocks_);
+        this->~TaskState();
+        blocks->Deallocate(this);
+      } else {
+        delete this;
+      }
+    }
+  }
+
+  bool IsReady() const { return ready_.load(std::memory_order_acquire); }
+
+  void Wait()
+  {
+    while (!IsReady()) {
+      ready_ec_.PrepareWait();
+      if (IsReady()) {
+        ready_ec_.CancelWait();
+        break;
+      }
+      ready_ec_.Wait();
+    }
+  }
+
+  template <typename... Args>
+  void SetValue(Args&&... args)
+  {
+    ::new (static_cast<void*>(&value_)) Value(std::forward<Args>(args)...);
+    has_value_ = true;
+    SetReady();
+  }
+
+  void SetException(std::exception_ptr exception)
+  {
+    exception_ = std::move(exception);
+    SetReady();
+  }
+
+  T Get()
+  {
+    Wait();
+    if (exception_) {
+      std::rethrow_exception(exception_);
+    }
+    if constexpr (std::is_void<T>::value) {
+      return;
+    } else {
+      return std::move(*ValuePtr());
+    }
+  }
+
+ private:
+  // 'void' results are stored as an empty value.
+  struct Empty {};
+  using Value =
+      typename std::conditional<std::is_void<T>::value, Empty, T>::type;
+
+  explicit TaskState(std::shared_ptr<FreeList> blocks)
+      : blocks_(std::move(blocks))
+  {
+  }
+
+  ~TaskState()
+  {
+    if (has_value_) {
+      ValuePtr()->~Value();
+    }
+  }
+
+  Value* ValuePtr() { return std::launder(reinterpret_cast<Value*>(&value_)); }
+
+  void SetReady()
+  {
+    ready_.store(true, std::memory_order_release);
+    ready_ec_.NotifyAll();
+  }
+
+  // One reference held by the promise and one by the future
+  std::atomic<uint32_t> refs_{2};
+  std::atomic<bool> ready_{false};
+  EventCount ready_ec_;
+  bool has_value_ = false;
+  std::exception_ptr exception_;
+  typename std::aligned_storage<sizeof(Value), alignof(Value)>::type value_;
+  std::shared_ptr<FreeList> blocks_;
+};
+
+template <typename T>
+class TaskFuture {
+ public:
+  TaskFuture() = default;
+  explicit TaskFuture(TaskState<T>* state) : state_(state) {}
+  TaskFuture(TaskFuture&& other) noexcept : state_(other.state_)
+  {
+    other.state_ = nullptr;
+  }
+  TaskFuture& operator=(TaskFuture&& other) noexcept
+  {
+    if (this != &other) {
+      Reset();
+      state_ = other.state_;
+      other.state_ = nullptr;
+    }
+    return *this;
+  }
+  TaskFuture(const TaskFuture&) = delete;
+  TaskFuture& operator=(const TaskFuture&) = delete;
+  ~TaskFuture() { Reset(); }
+
+  // Whether the future refers to a shared state, false after Get().
+  bool Valid() const { return state_ != nullptr; }
+
+  // Whether the result is available.
+  bool IsReady() const { return state_->IsReady(); }
+
+  // Block until the result is available.
+  void Wait() { state_->Wait(); }
+
+  // Block until the result is available and return it, or rethrow the
+  // exception thrown by the task. Releases the shared state.
+  T Get()
+  {
+    TaskState<T>* state = state_;
+    state_ = nullptr;
+    struct Releaser {
+      ~Releaser() { state->Release(); }
+      TaskState<T>* state;
+    } releaser{state};
+    return state->Get();
+  }
+
+ private:
+  void Reset()
+  {
+    if (state_ != nullptr) {
+      state_->Release();
+      state_ = nullptr;
+    }
+  }
+
+  TaskState<T>* state_ = nullptr;
+};
+
+template <typename T>
+class TaskPromise {
+ public:
+  explicit TaskPromise(TaskState<T>* state) : state_(state) {}
+  TaskPromise(TaskPromise&& other) noexcept : state_(other.state_)
+  {
+    other.state_ = nullptr;
+  }
+  TaskPromise& operator=(TaskPromise&&) = delete;
+  TaskPromise(const TaskPromise&) = delete;
+  TaskPromise& operator=(const TaskPromise&) = delete;
+
+  // A promise destroyed without a result, e.g. because its task was
+  // dropped, breaks the future.
+  ~TaskPromise()
+  {
+    if (state_ != nullptr) {
+      state_->SetException(std::make_exception_ptr(
+          std::future_error(std::future_errc::broken_promise)));
+      state_->Release();
+    }
+  }
+
+  // Run 'fn' and store its result, or the exception it throws.
+  template <typename F>
+  void SetFrom(F&& fn)
+  {
+    TaskState<T>* state = state_;
+    state_ = nullptr;
+    try {
+      if constexpr (std::is_void<T>::value) {
+        fn();
+        state->SetValue();
+      } else {
+        state->SetValue(fn());
+      }
+    }
+    catch (...) {
+      state->SetException(std::current_exception());
+    }
+    state->Release();
+  }
+
+ private:
+  TaskState<T>* state_;
+};
+
+}}  // namespace triton::common
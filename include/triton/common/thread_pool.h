@@ -1,4 +1,4 @@
-// Copyright 2022-2025, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright 2022-2026, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Redistribution and use in source and binary forms, with or without
 // modification, are permitted provided that the following conditions
@@ -25,10 +25,31 @@
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <functional>
-#include <queue>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
 #include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "cancellation_token.h"
+#include "event_count.h"
+#include "free_list.h"
+#include "inline_task.h"
+#include "task_future.h"
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#include <coroutine>
+#define TRITON_COMMON_ENABLE_COROUTINES
+#endif
 
 namespace triton { namespace common {
 
@@ -36,34 +57,381 @@ namespace triton { namespace common {
 
 class ThreadPool {
  public:
+  // Move-only task, callables of up to 'InlineTask::kInlineCapacity' bytes
+  // are stored without heap allocation.
+  using Task = InlineTask;
+
+  // How workers choose between priority levels.
+  enum class PriorityPolicy {
+    // Always run the task from the highest non-empty priority level.
+    kSTRICT,
+    // Share the workers between the non-empty levels in proportion to
+    // their weights.
+    kWEIGHTED
+  };
+
+  // What happens to the queued tasks on Shutdown().
+  enum class ShutdownMode {
+    // Run every queued task before the workers exit.
+    kRUN_REMAINING,
+    // Destroy the queued tasks that have not started without running them.
+    // The futures of discarded Submit() tasks report a broken promise.
+    kDISCARD_REMAINING
+  };
+
+  struct Options {
+    // Number of worker threads, must be greater than zero.
+    size_t thread_count = 1;
+
+    // If true, each worker owns a Chase-Lev deque. Tasks enqueued from a
+    // worker thread are pushed to that worker's deque and idle workers
+    // steal from randomly selected peers, so workers only touch the shared
+    // queue for tasks enqueued from outside the pool.
+    bool work_stealing = false;
+
+    // Maximum number of tasks a worker takes from the shared queue per lock
+    // acquisition. Values above 1 amortize synchronization for short tasks,
+    // at the cost of tasks waiting behind their batch while other workers
+    // are idle. In work-stealing mode the extra tasks are moved to the
+    // worker's deque, where idle peers can still steal them.
+    size_t max_tasks_per_wakeup = 1;
+
+    // Number of priority levels, following the convention of
+    // 'ModelDynamicBatching.priority_levels': level 1 is the highest
+    // priority. 0 disables priorities and the pool is a single FIFO queue.
+    // Not supported in work-stealing mode.
+    uint32_t priority_levels = 0;
+
+    // Priority level of tasks enqueued without a valid level. Must be in
+    // [1, 'priority_levels'] if priorities are enabled.
+    uint32_t default_priority_level = 0;
+
+    PriorityPolicy priority_policy = PriorityPolicy::kSTRICT;
+
+    // Relative weight of each level for 'PriorityPolicy::kWEIGHTED'. If
+    // empty, level 'l' has weight 'priority_levels - l + 1'.
+    std::vector<uint32_t> priority_weights;
+
+    // Tasks that have waited longer than 'aging_threshold' run before tasks
+    // of higher priority, oldest first, so that low priority work is not
+    // starved. Zero disables aging.
+    std::chrono::microseconds aging_threshold{0};
+
+    // CPUs to run the workers on, worker 'i' is pinned to
+    // 'cpus[i % cpus.size()]'. Empty leaves the workers unpinned. Only
+    // supported on Linux.
+    std::vector<int> cpus;
+
+    // NUMA nodes to run the workers on. The pool is split into one sub-pool
+    // per node, 'thread_count' being spread evenly across them, and each
+    // worker is pinned to a CPU of its node. Tasks are dispatched to the
+    // sub-pool of the node the enqueuing thread runs on, so tasks enqueued by
+    // a worker stay on its node. Cannot be combined with 'cpus'. Only
+    // supported on Linux.
+    std::vector<int> numa_nodes;
+
+    // If not empty, workers are named '<thread_name><index>', truncated to
+    // the 15 characters allowed for a thread name. Only applied on Linux.
+    std::string thread_name;
+
+    // If set, the nice level of the workers, e.g. 'GetCpuNiceLevel(config)'
+    // for the workers of a model. Only applied on Linux, on a best-effort
+    // basis as lowering the nice level may require privileges.
+    std::optional<int> nice_level;
+
+    // Maximum number of worker threads. If greater than 'thread_count' the
+    // pool is elastic: it starts with 'thread_count' workers, spawns more
+    // up to 'max_thread_count' when the load crosses 'grow_queue_depth' or
+    // 'grow_wait_time', and retires the extra workers once they have been
+    // idle for 'keepalive'. Not supported in work-stealing mode or with
+    // NUMA nodes.
+    size_t max_thread_count = 0;
+
+    // Spawn a worker when the number of queued tasks that the idle workers
+    // cannot take exceeds this depth.
+    size_t grow_queue_depth = 0;
+
+    // Spawn a worker when a queued task has waited longer than this. Zero
+    // disables the wait time trigger.
+    std::chrono::microseconds grow_wait_time{0};
+
+    // How long a worker above 'thread_count' may stay idle before it exits.
+    std::chrono::milliseconds keepalive{60000};
+
+    // If true, workers record the queue wait and run time of every task,
+    // see GetMetrics(). Costs two clock reads per task.
+    bool enable_metrics = false;
+
+    // Number of times an idle worker polls for a task before it parks, so
+    // that tasks arriving in quick succession are picked up without a
+    // wake-up system call. The budget adapts: a worker whose spin found no
+    // task halves it, down to an eighth of 'spin_count', and one whose spin
+    // succeeded restores it. 0 parks right away. Ignored by elastic pools
+    // and on single-CPU hosts, where spinning only delays the producer.
+    uint32_t spin_count = 128;
+  };
+
+  // Number of workers spawned and retired by an elastic pool since its
+  // construction.
+  struct ResizeCounters {
+    uint64_t grow_count = 0;
+    uint64_t shrink_count = 0;
+  };
+
   explicit ThreadPool(std::size_t thread_count);
+  explicit ThreadPool(const Options& options);
   ~ThreadPool();
   ThreadPool(const ThreadPool&) = delete;
   ThreadPool& operator=(const ThreadPool&) = delete;
 
-  using Task = std::function<void(void)>;
   // Assigns "task" to the task queue for a worker thread to execute when
-  // available. This will not track the return value of the task.
-  void Enqueue(Task&& task);
+  // available. This will not track the return value of the task. Returns
+  // false, leaving 'task' untouched, if the pool is shut down.
+  bool Enqueue(Task&& task) { return Enqueue(std::move(task), 0); }
+
+  // Same as above but 'task' is queued at 'priority_level'. A level outside
+  // [1, 'Options::priority_levels'] selects the default priority level.
+  bool Enqueue(Task&& task, uint32_t priority_level);
 
-  // Returns the number of tasks waiting in the queue
-  size_t TaskQueueSize()
+  // Same as above but 'task' is destroyed without running if 'token' is
+  // cancelled before a worker picks it up.
+  bool Enqueue(
+      Task&& task, const CancellationToken& token,
+      uint32_t priority_level = 0);
+
+  // Run 'f(args...)' on a worker thread and return a future for its result.
+  // 'f' and 'args' are decay-copied into the task. The future's shared state
+  // comes from a per-pool free list, so Submit() does not allocate in steady
+  // state as long as the task fits in 'InlineTask::kInlineCapacity' bytes.
+  // If the pool is shut down, or the task is discarded by Shutdown(), the
+  // future reports a broken promise.
+  template <typename F, typename... Args>
+  TaskFuture<typename std::invoke_result<
+      typename std::decay<F>::type, typename std::decay<Args>::type...>::type>
+  Submit(F&& f, Args&&... args)
   {
-    std::lock_guard<std::mutex> lk(queue_mtx_);
-    return task_queue_.size();
+    using Result = typename std::invoke_result<
+        typename std::decay<F>::type,
+        typename std::decay<Args>::type...>::type;
+    TaskState<Result>* state = TaskState<Result>::Create(state_blocks_);
+    TaskFuture<Result> future(state);
+    Enqueue([promise = TaskPromise<Result>(state), fn = std::forward<F>(f),
+             bound = std::make_tuple(std::forward<Args>(args)...)]() mutable {
+      promise.SetFrom(
+          [&]() { return std::apply(std::move(fn), std::move(bound)); });
+    });
+    return future;
   }
 
+  // Blocks until every enqueued task has run or been discarded, including
+  // tasks enqueued while draining, or until 'deadline'. Returns true if no
+  // task is left. The pool keeps accepting tasks. Must not be called from
+  // one of the pool's tasks.
+  bool Drain(
+      std::chrono::steady_clock::time_point deadline =
+          std::chrono::steady_clock::time_point::max());
+
+  // Stops accepting tasks, so that Enqueue() returns false, and waits for
+  // the workers to exit after handling the queued tasks as per 'mode'.
+  // Returns the number of discarded tasks. A bounded shutdown drains until
+  // a deadline and then discards what is left:
+  //
+  //   pool.Drain(std::chrono::steady_clock::now() + timeout);
+  //   pool.Shutdown(ThreadPool::ShutdownMode::kDISCARD_REMAINING);
+  //
+  // Called by the destructor with 'kRUN_REMAINING' if not called before.
+  // Must not be called from one of the pool's tasks.
+  size_t Shutdown(ShutdownMode mode = ShutdownMode::kRUN_REMAINING);
+
+  // Whether Shutdown() was called, after which tasks are rejected.
+  bool IsShutdown() const { return stop_; }
+
+  // Returns the number of tasks waiting in the queue. In work-stealing mode
+  // this includes the tasks waiting in the per-worker deques.
+  size_t TaskQueueSize();
+
+  // Returns the number of tasks waiting at 'priority_level', 0 if the level
+  // is outside [1, 'Options::priority_levels'].
+  size_t TaskQueueSize(uint32_t priority_level);
+
   // Returns the number of threads in thread pool
-  size_t Size() const { return workers_.size(); }
+  size_t Size() const;
+
+  // Returns the resize counters, always zero unless the pool is elastic.
+  ResizeCounters GetResizeCounters() const;
+
+  // Number of buckets of the latency histograms. Bucket 0 counts durations
+  // under 1 microsecond, bucket 'i' durations in [2^(i-1), 2^i)
+  // microseconds and the last bucket all longer durations.
+  static constexpr size_t kHistogramBuckets = 24;
+
+  struct WorkerMetrics {
+    uint64_t tasks_completed = 0;
+    std::chrono::nanoseconds busy_time{0};
+    // 'busy_time' over the pool uptime.
+    double busy_ratio = 0;
+  };
+
+  // Snapshot of the pool activity since its construction. The counters are
+  // read without synchronizing with the workers, so a snapshot taken while
+  // tasks run may be slightly inconsistent. Only the queue depths and the
+  // resize counters are collected unless 'Options::enable_metrics' is set.
+  struct Metrics {
+    std::chrono::nanoseconds uptime{0};
+    uint64_t tasks_enqueued = 0;
+    uint64_t tasks_completed = 0;
+    // Current and highest number of tasks in the shared queue.
+    size_t queue_depth = 0;
+    size_t peak_queue_depth = 0;
+    // Sum over the completed tasks of the time from enqueue to start and of
+    // the time spent running.
+    std::chrono::nanoseconds total_queue_wait{0};
+    std::chrono::nanoseconds total_run_time{0};
+    std::array<uint64_t, kHistogramBuckets> queue_wait_histogram{};
+    std::array<uint64_t, kHistogramBuckets> run_time_histogram{};
+    // One entry per worker slot, an elastic pool has 'max_thread_count'
+    // slots that its workers reuse.
+    std::vector<WorkerMetrics> workers;
+    ResizeCounters resize_counters;
+  };
+
+  // Returns a snapshot of the pool metrics.
+  Metrics GetMetrics() const;
 
  private:
-  std::queue<Task> task_queue_;
+  struct Worker;
+  struct QueuedTask;
+  struct WorkerStats;
+  class TaskRing;
+
+  void InitWorkerThread(size_t index);
+  void SpawnWorkerLocked();
+  void RetireWorkerLocked(size_t slot);
+  bool ShouldGrowLocked();
+  ThreadPool& NodePool();
+  void WorkerLoop(size_t slot);
+  void WorkStealingWorkerLoop(size_t index);
+  void RunTask(QueuedTask& queued, WorkerStats* stats);
+  void FinishTasks(size_t count);
+  bool EnqueueImpl(
+      Task&& task, std::shared_ptr<std::atomic<bool>>&& cancelled,
+      uint32_t priority_level);
+  bool FindTask(size_t index, uint32_t* seed, QueuedTask* task);
+  bool HasQueuedTasks();
+
+  // Polls 'has_work' for up to '*spin_budget' times, adapting the budget.
+  // Returns whether there is work.
+  template <typename Predicate>
+  bool SpinForWork(uint32_t* spin_budget, Predicate has_work);
+
+  // Spins, then parks on 'work_ec_', until 'has_work' returns true.
+  template <typename Predicate>
+  void WaitForWork(uint32_t* spin_budget, Predicate has_work);
+  bool PopTaskLocked(QueuedTask* task);
+  size_t SelectLevelLocked();
+
+  // Block size used for the shared state of Submit() futures.
+  static constexpr size_t kStateBlockSize = 256;
+
+  // Free lists backing the shared state of Submit() futures, which may
+  // outlive the pool, and the task nodes of the work-stealing deques.
+  std::shared_ptr<FreeList> state_blocks_;
+  FreeList task_blocks_;
+
+  // One FIFO queue per priority level, index 0 being the highest priority.
+  std::vector<TaskRing> task_queues_;
+  // Total number of tasks in 'task_queues_'. Only modified with
+  // 'queue_mtx_' held but atomic so that it can be read without the lock.
+  std::atomic<size_t> queued_count_{0};
   std::mutex queue_mtx_;
+  // Idle workers of elastic pools wait on 'cv_' so that they can time out,
+  // other workers park on 'work_ec_', which producers notify without a
+  // system call unless a worker is parked.
   std::condition_variable cv_;
+  EventCount work_ec_;
+  const uint32_t spin_count_;
   std::vector<std::thread> workers_;
+  // Number of entries in 'workers_', readable without 'queue_mtx_'.
+  std::atomic<size_t> worker_count_{0};
   // If true, tells pool to stop accepting work and tells awake worker threads
   // to exit when no tasks are left on the queue.
-  bool stop_ = false;
+  std::atomic<bool> stop_{false};
+  // If true, workers destroy the tasks they pick up instead of running them.
+  std::atomic<bool> discard_{false};
+  // Number of tasks discarded by the workers after 'discard_' was set.
+  std::atomic<size_t> discarded_count_{0};
+  // Serializes Shutdown() calls.
+  std::mutex shutdown_mtx_;
+
+  // Number of accepted tasks that have not finished running or been
+  // discarded, in the queues or in the workers' hands.
+  std::atomic<size_t> pending_count_{0};
+  // Number of Drain() calls waiting on 'drain_cv_' with 'queue_mtx_',
+  // workers finishing the last pending task only notify if non-zero.
+  std::atomic<size_t> drain_waiters_{0};
+  std::condition_variable drain_cv_;
+
+  const size_t max_tasks_per_wakeup_;
+
+  // Priority state, only used if 'Options::priority_levels' is set.
+  size_t default_level_index_ = 0;
+  PriorityPolicy priority_policy_;
+  std::chrono::steady_clock::duration aging_threshold_;
+  // Stride scheduling for 'PriorityPolicy::kWEIGHTED': each level advances
+  // its pass by its stride when it runs a task, the non-empty level with the
+  // smallest pass runs next.
+  std::vector<uint64_t> strides_;
+  std::vector<uint64_t> passes_;
+  uint64_t current_pass_ = 0;
+  // Whether queued tasks record their enqueue time, needed for aging and
+  // the wait time trigger of elastic pools.
+  bool record_enqueue_time_;
+
+  // Elastic state, only used if 'Options::max_thread_count' is greater
+  // than 'Options::thread_count'. All but the counters are protected by
+  // 'queue_mtx_'.
+  const bool elastic_;
+  const size_t min_thread_count_;
+  const size_t max_thread_count_;
+  const size_t grow_queue_depth_;
+  const std::chrono::steady_clock::duration grow_wait_time_;
+  const std::chrono::milliseconds keepalive_;
+  // Number of workers waiting on 'cv_' for a task.
+  size_t idle_count_ = 0;
+  // Worker slots not used by a running worker. A slot gives a worker its
+  // name, CPU and metrics.
+  std::vector<size_t> free_slots_;
+  // Workers that exited after their keepalive, joined on the next spawn or
+  // on destruction.
+  std::vector<std::thread> retired_workers_;
+  std::atomic<uint64_t> grow_count_{0};
+  std::atomic<uint64_t> shrink_count_{0};
+
+  // Work-stealing state, empty unless 'Options::work_stealing' is set.
+  const bool work_stealing_;
+  std::vector<std::unique_ptr<Worker>> stealing_workers_;
+
+  // Worker thread settings, see 'Options'.
+  std::vector<int> cpus_;
+  std::string thread_name_;
+  std::optional<int> nice_level_;
+
+  // Per-node sub-pools, empty unless 'Options::numa_nodes' is set, in which
+  // case this pool has no worker of its own and forwards every task.
+  std::vector<std::unique_ptr<ThreadPool>> node_pools_;
+  // Index in 'node_pools_' of the node of each CPU, -1 for CPUs of other
+  // nodes.
+  std::vector<int> cpu_node_pools_;
+  // Round-robin dispatch for threads running outside the pool's nodes.
+  std::atomic<size_t> next_node_pool_{0};
+
+  // Metrics, see GetMetrics(). 'worker_stats_' has one entry per worker
+  // slot if 'Options::enable_metrics' is set and is empty otherwise.
+  const std::chrono::steady_clock::time_point start_time_;
+  std::vector<std::unique_ptr<WorkerStats>> worker_stats_;
+  std::atomic<uint64_t> tasks_enqueued_{0};
+  // Only modified with 'queue_mtx_' held.
+  std::atomic<size_t> peak_queue_depth_{0};
 };
 
 }}  // namespace triton::common
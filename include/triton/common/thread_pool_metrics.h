@@ -0,0 +1,129 @@
+// Copyright 2026, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <sstream>
+#include <string>
+
+#include "table_printer.h"
+#include "thread_pool.h"
+
+namespace triton { namespace common {
+
+//
+// Helpers to report ThreadPool::Metrics. Users of this header must link
+// the table printer library.
+//
+
+// Returns the upper bound, in microseconds, of the histogram bucket that
+// holds quantile 'q' in [0, 1] of the recorded durations. The last bucket
+// is unbounded so durations that fall in it are reported as its lower
+// bound. Returns 0 if the histogram is empty.
+inline uint64_t
+ThreadPoolHistogramQuantile(
+    const std::array<uint64_t, ThreadPool::kHistogramBuckets>& histogram,
+    double q)
+{
+  uint64_t total = 0;
+  for (const uint64_t count : histogram) {
+    total += count;
+  }
+  if (total == 0) {
+    return 0;
+  }
+  const double rank = q * static_cast<double>(total);
+  uint64_t seen = 0;
+  for (size_t i = 0; i < ThreadPool::kHistogramBuckets; ++i) {
+    seen += histogram[i];
+    if ((seen != 0) && (static_cast<double>(seen) >= rank)) {
+      return (i + 1 < ThreadPool::kHistogramBuckets) ? (uint64_t(1) << i)
+                                                     : (uint64_t(1) << (i - 1));
+    }
+  }
+  return uint64_t(1) << (ThreadPool::kHistogramBuckets - 2);
+}
+
+// Returns 'metrics' as two ASCII tables, the pool totals followed by one
+// row per worker.
+inline std::string
+ThreadPoolMetricsTable(const ThreadPool::Metrics& metrics)
+{
+  auto us = [](std::chrono::nanoseconds duration) {
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(1)
+       << (static_cast<double>(duration.count()) / 1000.0);
+    return ss.str();
+  };
+  auto mean = [&metrics](std::chrono::nanoseconds total) {
+    return (metrics.tasks_completed == 0)
+               ? std::chrono::nanoseconds(0)
+               : total / static_cast<int64_t>(metrics.tasks_completed);
+  };
+
+  TablePrinter summary({"Metric", "Value"});
+  summary.InsertRow({"Uptime (us)", us(metrics.uptime)});
+  summary.InsertRow({"Tasks enqueued", std::to_string(metrics.tasks_enqueued)});
+  summary.InsertRow(
+      {"Tasks completed", std::to_string(metrics.tasks_completed)});
+  summary.InsertRow({"Queue depth", std::to_string(metrics.queue_depth)});
+  summary.InsertRow(
+      {"Peak queue depth", std::to_string(metrics.peak_queue_depth)});
+  summary.InsertRow(
+      {"Mean queue wait (us)", us(mean(metrics.total_queue_wait))});
+  summary.InsertRow(
+      {"P99 queue wait (us)",
+       std::to_string(
+           ThreadPoolHistogramQuantile(metrics.queue_wait_histogram, 0.99))});
+  summary.InsertRow({"Mean run time (us)", us(mean(metrics.total_run_time))});
+  summary.InsertRow(
+      {"P99 run time (us)",
+       std::to_string(
+           ThreadPoolHistogramQuantile(metrics.run_time_histogram, 0.99))});
+  summary.InsertRow(
+      {"Workers spawned",
+       std::to_string(metrics.resize_counters.grow_count)});
+  summary.InsertRow(
+      {"Workers retired",
+       std::to_string(metrics.resize_counters.shrink_count)});
+
+  TablePrinter workers({"Worker", "Tasks completed", "Busy (us)", "Busy %"});
+  for (size_t i = 0; i < metrics.workers.size(); ++i) {
+    const auto& worker = metrics.workers[i];
+    std::stringstream ratio;
+    ratio << std::fixed << std::setprecision(1)
+          << (worker.busy_ratio * 100.0);
+    workers.InsertRow(
+        {std::to_string(i), std::to_string(worker.tasks_completed),
+         us(worker.busy_time), ratio.str()});
+  }
+  return summary.PrintTable() + workers.PrintTable();
+}
+
+}}  // namespace triton::common
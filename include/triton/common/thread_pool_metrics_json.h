@@ -0,0 +1,85 @@
+// Copyright 2026, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include <string>
+#include <utility>
+
+#include "thread_pool.h"
+#include "triton_json.h"
+
+namespace triton { namespace common {
+
+//
+// Returns 'metrics' serialized as a JSON object, durations being in
+// nanoseconds and histograms arrays of 'ThreadPool::kHistogramBuckets'
+// counts. As for triton_json.h, the TRITONJSON_* macros must be defined
+// before including this header.
+//
+inline std::string
+ThreadPoolMetricsJson(const ThreadPool::Metrics& metrics)
+{
+  // The document is built from values created here with the right types,
+  // so adding members and elements can't fail and statuses are not checked.
+  TritonJson::Value json(TritonJson::ValueType::OBJECT);
+  json.AddUInt("uptime_ns", metrics.uptime.count());
+  json.AddUInt("tasks_enqueued", metrics.tasks_enqueued);
+  json.AddUInt("tasks_completed", metrics.tasks_completed);
+  json.AddUInt("queue_depth", metrics.queue_depth);
+  json.AddUInt("peak_queue_depth", metrics.peak_queue_depth);
+  json.AddUInt("total_queue_wait_ns", metrics.total_queue_wait.count());
+  json.AddUInt("total_run_time_ns", metrics.total_run_time.count());
+
+  TritonJson::Value queue_wait(json, TritonJson::ValueType::ARRAY);
+  TritonJson::Value run_time(json, TritonJson::ValueType::ARRAY);
+  for (size_t i = 0; i < ThreadPool::kHistogramBuckets; ++i) {
+    queue_wait.AppendUInt(metrics.queue_wait_histogram[i]);
+    run_time.AppendUInt(metrics.run_time_histogram[i]);
+  }
+  json.Add("queue_wait_histogram", std::move(queue_wait));
+  json.Add("run_time_histogram", std::move(run_time));
+
+  TritonJson::Value workers(json, TritonJson::ValueType::ARRAY);
+  for (const auto& worker : metrics.workers) {
+    TritonJson::Value worker_json(json, TritonJson::ValueType::OBJECT);
+    worker_json.AddUInt("tasks_completed", worker.tasks_completed);
+    worker_json.AddUInt("busy_time_ns", worker.busy_time.count());
+    worker_json.AddDouble("busy_ratio", worker.busy_ratio);
+    workers.Append(std::move(worker_json));
+  }
+  json.Add("workers", std::move(workers));
+
+  TritonJson::Value resize(json, TritonJson::ValueType::OBJECT);
+  resize.AddUInt("grow_count", metrics.resize_counters.grow_count);
+  resize.AddUInt("shrink_count", metrics.resize_counters.shrink_count);
+  json.Add("resize_counters", std::move(resize));
+
+  TritonJson::WriteBuffer buffer;
+  json.Write(&buffer);
+  return std::move(buffer.MutableContents());
+}
+
+}}  // namespace triton::common
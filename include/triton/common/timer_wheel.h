@@ -0,0 +1,154 @@
+// Copyright 2026, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "thread_pool.h"
+
+namespace triton { namespace common {
+
+//
+// Hierarchical timing wheel that queues tasks on a ThreadPool once their
+// deadline is reached, e.g. for queue timeouts, sequence idle expiry or
+// retry backoff. A single timer thread serves all timers.
+//
+// Deadlines are rounded up to the wheel's tick. Timers are kept in four
+// levels of 64 slots each, the first covering the next 64 ticks and every
+// further level 64 times the range of the previous one, so scheduling and
+// cancelling a timer are O(1) and each timer is moved to a lower level at
+// most three times before it expires. Timers beyond the last level are
+// parked in it and re-placed when reached. The timer thread sleeps until
+// the next tick with an expiring slot or a cascade, and indefinitely while
+// no timer is pending. Tasks rejected by the pool, e.g. after it is shut
+// down, are destroyed without running.
+//
+class TimerWheel {
+ public:
+  using Clock = std::chrono::steady_clock;
+  using Task = ThreadPool::Task;
+
+  // Identifies a scheduled timer, 0 is never a valid ID.
+  using TimerId = uint64_t;
+
+  // Starts the timer thread. Due tasks are queued on 'pool', which must
+  // outlive the wheel.
+  explicit TimerWheel(
+      ThreadPool* pool,
+      std::chrono::microseconds tick = std::chrono::milliseconds(1));
+
+  // Stops the timer thread, pending timers are destroyed without running.
+  ~TimerWheel();
+
+  TimerWheel(const TimerWheel&) = delete;
+  TimerWheel& operator=(const TimerWheel&) = delete;
+
+  // Queues 'task' on the pool at 'deadline', or on the next tick if it
+  // has passed.
+  TimerId ScheduleAt(Clock::time_point deadline, Task&& task);
+
+  // Queues 'task' on the pool after 'delay'.
+  template <typename Rep, typename Period>
+  TimerId ScheduleAfter(
+      const std::chrono::duration<Rep, Period>& delay, Task&& task)
+  {
+    return ScheduleAt(
+        Clock::now() + std::chrono::duration_cast<Clock::duration>(delay),
+        std::move(task));
+  }
+
+  // Cancels the timer 'id', destroying its task. Returns false if the
+  // timer has already been handed to the pool or cancelled.
+  bool Cancel(TimerId id);
+
+  // Returns the number of timers that have not expired.
+  size_t PendingCount() const;
+
+ private:
+  static constexpr size_t kLevels = 4;
+  static constexpr size_t kSlotBits = 6;
+  static constexpr size_t kSlots = size_t(1) << kSlotBits;
+  static constexpr uint64_t kSlotMask = kSlots - 1;
+  static constexpr uint32_t kNil = UINT32_MAX;
+
+  struct Timer {
+    Task task_;
+    uint64_t expiry_ = 0;
+    uint32_t generation_ = 1;
+    uint32_t prev_ = kNil;
+    uint32_t next_ = kNil;
+    // Slot index over all levels, 'kNil' when the timer is not scheduled
+    uint32_t slot_ = kNil;
+  };
+
+  void TimerThread();
+
+  // Returns the first tick at or after 'time'.
+  uint64_t TickAt(Clock::time_point time) const;
+
+  // Places timer 'index' in the slot its expiry falls into.
+  void InsertLocked(uint32_t index);
+  void UnlinkLocked(uint32_t index);
+  void FreeLocked(uint32_t index);
+
+  // Moves the timers of the slot reached at 'tick' in every level above
+  // the first down to lower levels.
+  void CascadeLocked(uint64_t tick);
+
+  // Processes the ticks up to and including 'tick', moving the tasks of
+  // the expired timers to 'expired'.
+  void AdvanceLocked(uint64_t tick, std::vector<Task>* expired);
+
+  // Returns the next tick to wake up at to expire or cascade timers.
+  uint64_t NextWakeTickLocked() const;
+
+  ThreadPool* const pool_;
+  const Clock::duration tick_;
+  const Clock::time_point start_;
+
+  mutable std::mutex mtx_;
+  std::condition_variable cv_;
+  bool exit_ = false;
+
+  // Last processed tick
+  uint64_t current_tick_ = 0;
+  size_t pending_count_ = 0;
+  std::vector<Timer> timers_;
+  std::vector<uint32_t> free_timers_;
+  std::array<uint32_t, kLevels * kSlots> heads_;
+  // Bit per non-empty slot, for each level
+  std::array<uint64_t, kLevels> occupied_{};
+
+  std::thread thread_;
+};
+
+}}  // namespace triton::common
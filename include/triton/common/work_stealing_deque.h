@@ -0,0 +1,184 @@
+// Copyright 2026, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace triton { namespace common {
+
+//
+// Chase-Lev work-stealing deque, using the memory orderings from
+// "Correct and Efficient Work-Stealing for Weak Memory Models"
+// (Le et al., PPoPP 2013).
+//
+// The owning thread pushes and pops at the bottom, any other thread may
+// steal from the top. 'Item' must be trivially copyable (typically a
+// pointer) since thieves may read a slot that is concurrently overwritten
+// and discard it when their claim fails.
+//
+template <typename Item>
+class WorkStealingDeque {
+  static_assert(
+      std::is_trivially_copyable<Item>::value,
+      "WorkStealingDeque requires a trivially copyable item type");
+
+ public:
+  explicit WorkStealingDeque(size_t initial_capacity = 256)
+      : top_(0), bottom_(0)
+  {
+    size_t capacity = 1;
+    while (capacity < initial_capacity) {
+      capacity <<= 1;
+    }
+    buffers_.emplace_back(new Buffer(capacity));
+    buffer_.store(buffers_.back().get(), std::memory_order_relaxed);
+  }
+
+  WorkStealingDeque(const WorkStealingDeque&) = delete;
+  WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+  // Approximate number of items in the deque.
+  size_t Size() const
+  {
+    const int64_t b = bottom_.load(std::memory_order_relaxed);
+    const int64_t t = top_.load(std::memory_order_relaxed);
+    return (b > t) ? static_cast<size_t>(b - t) : 0;
+  }
+
+  bool Empty() const { return Size() == 0; }
+
+  // Push 'item' at the bottom. Must only be called by the owning thread.
+  void Push(Item item)
+  {
+    const int64_t b = bottom_.load(std::memory_order_relaxed);
+    const int64_t t = top_.load(std::memory_order_acquire);
+    Buffer* buffer = buffer_.load(std::memory_order_relaxed);
+    if ((b - t) > static_cast<int64_t>(buffer->Capacity()) - 1) {
+      buffer = Grow(buffer, t, b);
+    }
+    buffer->Put(b, item);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom_.store(b + 1, std::memory_order_relaxed);
+  }
+
+  // Pop the most recently pushed item. Must only be called by the owning
+  // thread. Returns false if the deque is empty.
+  bool Pop(Item* item)
+  {
+    const int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+    Buffer* buffer = buffer_.load(std::memory_order_relaxed);
+    bottom_.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t t = top_.load(std::memory_order_relaxed);
+
+    bool found = false;
+    if (t <= b) {
+      *item = buffer->Get(b);
+      found = true;
+      if (t == b) {
+        // Last item, race against thieves for it.
+        if (!top_.compare_exchange_strong(
+                t, t + 1, std::memory_order_seq_cst,
+                std::memory_order_relaxed)) {
+          found = false;
+        }
+        bottom_.store(b + 1, std::memory_order_relaxed);
+      }
+    } else {
+      bottom_.store(b + 1, std::memory_order_relaxed);
+    }
+    return found;
+  }
+
+  // Steal the oldest item. May be called by any thread. Returns false if
+  // the deque is empty or the steal lost a race with another thread.
+  bool Steal(Item* item)
+  {
+    int64_t t = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const int64_t b = bottom_.load(std::memory_order_acquire);
+    if (t < b) {
+      Buffer* buffer = buffer_.load(std::memory_order_acquire);
+      Item res = buffer->Get(t);
+      if (!top_.compare_exchange_strong(
+              t, t + 1, std::memory_order_seq_cst,
+              std::memory_order_relaxed)) {
+        return false;
+      }
+      *item = res;
+      return true;
+    }
+    return false;
+  }
+
+ private:
+  class Buffer {
+   public:
+    explicit Buffer(size_t capacity)
+        : mask_(capacity - 1), slots_(new std::atomic<Item>[capacity])
+    {
+    }
+    size_t Capacity() const { return mask_ + 1; }
+    Item Get(int64_t idx) const
+    {
+      return slots_[idx & mask_].load(std::memory_order_relaxed);
+    }
+    void Put(int64_t idx, Item item)
+    {
+      slots_[idx & mask_].store(item, std::memory_order_relaxed);
+    }
+
+   private:
+    const size_t mask_;
+    std::unique_ptr<std::atomic<Item>[]> slots_;
+  };
+
+  Buffer* Grow(Buffer* buffer, int64_t top, int64_t bottom)
+  {
+    // Thieves may still be reading from the old buffer, so retired buffers
+    // are kept until the deque is destroyed.
+    buffers_.emplace_back(new Buffer(buffer->Capacity() * 2));
+    Buffer* grown = buffers_.back().get();
+    for (int64_t i = top; i < bottom; ++i) {
+      grown->Put(i, buffer->Get(i));
+    }
+    buffer_.store(grown, std::memory_order_release);
+    return grown;
+  }
+
+  // Keep 'top_' and 'bottom_' on separate cache lines as they are written
+  // by thieves and the owner respectively.
+  alignas(64) std::atomic<int64_t> top_;
+  alignas(64) std::atomic<int64_t> bottom_;
+  alignas(64) std::atomic<Buffer*> buffer_;
+  std::vector<std::unique_ptr<Buffer>> buffers_;
+};
+
+}}  // namespace triton::common
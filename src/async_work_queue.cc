@@ -1,4 +1,4 @@
-// Copyright 2020-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright 2020-2026, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Redistribution and use in source and binary forms, with or without
 // modification, are permitted provided that the following conditions
@@ -26,66 +26,285 @@
 
 #include "triton/common/async_work_queue.h"
 
+#include <stdexcept>
+
 namespace triton { namespace common {
 
-AsyncWorkQueue::~AsyncWorkQueue()
+WorkQueue::~WorkQueue()
 {
-  GetSingleton()->thread_pool_.reset();
+  // Delayed and serial tasks are queued on the pool, stop them first
+  timers_.reset();
+  strands_.reset();
+  thread_pool_.reset();
 }
 
-AsyncWorkQueue*
-AsyncWorkQueue::GetSingleton()
+Error
+WorkQueue::Initialize(size_t worker_count)
 {
-  static AsyncWorkQueue singleton;
-  return &singleton;
+  ThreadPool::Options options;
+  options.thread_count = worker_count;
+  return Initialize(options);
 }
 
 Error
-AsyncWorkQueue::Initialize(size_t worker_count)
+WorkQueue::Initialize(const ThreadPool::Options& options)
 {
-  if (worker_count < 1) {
+  if (options.thread_count < 1) {
     return Error(
         Error::Code::INVALID_ARG,
-        "Async work queue must be initialized with positive 'worker_count'");
+        "Async work queue '" + name_ +
+            "' must be initialized with positive 'worker_count'");
   }
 
-  static std::mutex init_mtx;
-  std::lock_guard<std::mutex> lk(init_mtx);
+  std::lock_guard<std::mutex> lk(init_mtx_);
 
-  if (GetSingleton()->thread_pool_) {
+  if (thread_pool_) {
     return Error(
         Error::Code::ALREADY_EXISTS,
-        "Async work queue has been initialized with " +
-            std::to_string(GetSingleton()->thread_pool_->Size()) +
-            " 'worker_count'");
+        "Async work queue '" + name_ + "' has been initialized with " +
+            std::to_string(thread_pool_->Size()) + " 'worker_count'");
   }
 
-  GetSingleton()->thread_pool_.reset(new ThreadPool(worker_count));
+  try {
+    thread_pool_.reset(new ThreadPool(options));
+  }
+  catch (const std::invalid_argument& ex) {
+    return Error(Error::Code::INVALID_ARG, ex.what());
+  }
+  strands_.reset(new StrandExecutor<uint64_t>(thread_pool_.get()));
   return Error::Success;
 }
 
 size_t
-AsyncWorkQueue::WorkerCount()
+WorkQueue::WorkerCount() const
 {
-  if (!GetSingleton()->thread_pool_) {
+  if (!thread_pool_) {
     return 0;
   }
-  return GetSingleton()->thread_pool_->Size();
+  return thread_pool_->Size();
 }
 
 Error
-AsyncWorkQueue::AddTask(std::function<void(void)>&& task)
+WorkQueue::GetMetrics(ThreadPool::Metrics* metrics) const
+{
+  if (!thread_pool_) {
+    return Error(
+        Error::Code::UNAVAILABLE,
+        "Async work queue '" + name_ +
+            "' must be initialized before getting metrics");
+  }
+  *metrics = thread_pool_->GetMetrics();
+  return Error::Success;
+}
+
+Error
+WorkQueue::AddTask(std::function<void(void)>&& task, uint32_t priority_level)
+{
+  if (!thread_pool_) {
+    return Error(
+        Error::Code::UNAVAILABLE,
+        "Async work queue '" + name_ +
+            "' must be initialized before adding task");
+  }
+  if (!thread_pool_->Enqueue(std::move(task), priority_level)) {
+    return Error(
+        Error::Code::UNAVAILABLE,
+        "Async work queue '" + name_ +
+            "' is shutting down and does not accept tasks");
+  }
+
+  return Error::Success;
+}
+
+Error
+WorkQueue::AddSerialTask(uint64_t key, std::function<void(void)>&& task)
 {
-  if (!GetSingleton()->thread_pool_) {
+  if (!strands_) {
     return Error(
         Error::Code::UNAVAILABLE,
-        "Async work queue must be initialized before adding task");
+        "Async work queue '" + name_ +
+            "' must be initialized before adding task");
+  }
+  if (!strands_->Post(key, std::move(task))) {
+    return Error(
+        Error::Code::UNAVAILABLE,
+        "Async work queue '" + name_ +
+            "' is shutting down and does not accept tasks");
+  }
+
+  return Error::Success;
+}
+
+TimerWheel*
+WorkQueue::Timers()
+{
+  std::call_once(timers_once_, [this]() {
+    timers_.reset(new TimerWheel(thread_pool_.get()));
+    has_timers_ = true;
+  });
+  return timers_.get();
+}
+
+Error
+WorkQueue::AddTaskAt(
+    std::chrono::steady_clock::time_point deadline,
+    std::function<void(void)>&& task, TimerWheel::TimerId* timer_id)
+{
+  if (!thread_pool_) {
+    return Error(
+        Error::Code::UNAVAILABLE,
+        "Async work queue '" + name_ +
+            "' must be initialized before adding task");
+  }
+  if (thread_pool_->IsShutdown()) {
+    return Error(
+        Error::Code::UNAVAILABLE,
+        "Async work queue '" + name_ +
+            "' is shutting down and does not accept tasks");
+  }
+  const TimerWheel::TimerId id =
+      Timers()->ScheduleAt(deadline, std::move(task));
+  if (timer_id != nullptr) {
+    *timer_id = id;
+  }
+
+  return Error::Success;
+}
+
+Error
+WorkQueue::AddTaskAfter(
+    std::chrono::microseconds delay, std::function<void(void)>&& task,
+    TimerWheel::TimerId* timer_id)
+{
+  return AddTaskAt(
+      std::chrono::steady_clock::now() + delay, std::move(task), timer_id);
+}
+
+Error
+WorkQueue::CancelTask(TimerWheel::TimerId timer_id)
+{
+  // No timer was ever scheduled if the timer wheel was not created
+  if (!has_timers_ || !timers_->Cancel(timer_id)) {
+    return Error(
+        Error::Code::NOT_FOUND,
+        "Async work queue '" + name_ + "' has no delayed task " +
+            std::to_string(timer_id));
   }
-  GetSingleton()->thread_pool_->Enqueue(std::move(task));
 
   return Error::Success;
 }
 
+AsyncWorkQueue::AsyncWorkQueue()
+{
+  default_queue_ = new WorkQueue(kDefaultQueue);
+  queues_[kDefaultQueue].reset(default_queue_);
+}
+
+AsyncWorkQueue::~AsyncWorkQueue()
+{
+  GetSingleton()->queues_.clear();
+}
+
+AsyncWorkQueue*
+AsyncWorkQueue::GetSingleton()
+{
+  static AsyncWorkQueue singleton;
+  return &singleton;
+}
+
+WorkQueue*
+AsyncWorkQueue::Get(const std::string& name)
+{
+  AsyncWorkQueue* singleton = GetSingleton();
+  std::lock_guard<std::mutex> lk(singleton->registry_mtx_);
+  auto& queue = singleton->queues_[name];
+  if (!queue) {
+    queue.reset(new WorkQueue(name));
+  }
+  return queue.get();
+}
+
+std::vector<std::string>
+AsyncWorkQueue::QueueNames()
+{
+  AsyncWorkQueue* singleton = GetSingleton();
+  std::lock_guard<std::mutex> lk(singleton->registry_mtx_);
+  std::vector<std::string> names;
+  for (const auto& queue : singleton->queues_) {
+    names.push_back(queue.first);
+  }
+  return names;
+}
+
+Error
+AsyncWorkQueue::Initialize(size_t worker_count)
+{
+  return GetSingleton()->default_queue_->Initialize(worker_count);
+}
+
+Error
+AsyncWorkQueue::Initialize(const ThreadPool::Options& options)
+{
+  return GetSingleton()->default_queue_->Initialize(options);
+}
+
+size_t
+AsyncWorkQueue::WorkerCount()
+{
+  return GetSingleton()->default_queue_->WorkerCount();
+}
+
+Error
+AsyncWorkQueue::GetMetrics(ThreadPool::Metrics* metrics)
+{
+  return GetSingleton()->default_queue_->GetMetrics(metrics);
+}
+
+Error
+AsyncWorkQueue::AddTask(std::function<void(void)>&& task)
+{
+  return GetSingleton()->default_queue_->AddTask(std::move(task));
+}
+
+Error
+AsyncWorkQueue::AddTask(
+    std::function<void(void)>&& task, uint32_t priority_level)
+{
+  return GetSingleton()->default_queue_->AddTask(
+      std::move(task), priority_level);
+}
+
+Error
+AsyncWorkQueue::AddSerialTask(
+    uint64_t key, std::function<void(void)>&& task)
+{
+  return GetSingleton()->default_queue_->AddSerialTask(key, std::move(task));
+}
+
+Error
+AsyncWorkQueue::AddTaskAt(
+    std::chrono::steady_clock::time_point deadline,
+    std::function<void(void)>&& task, TimerWheel::TimerId* timer_id)
+{
+  return GetSingleton()->default_queue_->AddTaskAt(
+      deadline, std::move(task), timer_id);
+}
+
+Error
+AsyncWorkQueue::AddTaskAfter(
+    std::chrono::microseconds delay, std::function<void(void)>&& task,
+    TimerWheel::TimerId* timer_id)
+{
+  return GetSingleton()->default_queue_->AddTaskAfter(
+      delay, std::move(task), timer_id);
+}
+
+Error
+AsyncWorkQueue::CancelTask(TimerWheel::TimerId timer_id)
+{
+  return GetSingleton()->default_queue_->CancelTask(timer_id);
+}
+
 void
 AsyncWorkQueue::Reset()
 {
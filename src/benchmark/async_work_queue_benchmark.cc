@@ -0,0 +1,136 @@
+// Copyright 2026, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <chrono>
+
+#include "benchmark_util.h"
+#include "triton/common/async_work_queue.h"
+
+namespace tc = triton::common;
+namespace bench = triton::common::bench;
+
+namespace {
+
+// Throughput of trivial tasks added by 'state.range(0)' producers to a
+// queue of 'state.range(1)' workers.
+void
+BM_AddTask(benchmark::State& state)
+{
+  const size_t producers = state.range(0);
+  tc::WorkQueue queue("benchmark");
+  if (!queue.Initialize(state.range(1)).IsOk()) {
+    state.SkipWithError("failed to initialize the queue");
+    return;
+  }
+  std::atomic<size_t> remaining{0};
+  bench::ThreadTeam team(producers, [&](size_t index) {
+    const size_t count =
+        bench::ShareOf(bench::kItemsPerRound, index, producers);
+    for (size_t i = 0; i < count; ++i) {
+      queue.AddTask(
+          [&remaining] { remaining.fetch_sub(1, std::memory_order_release); });
+    }
+  });
+  for (auto _ : state) {
+    remaining.store(bench::kItemsPerRound, std::memory_order_relaxed);
+    team.Run();
+    bench::WaitForZero(remaining);
+  }
+  state.SetItemsProcessed(state.iterations() * bench::kItemsPerRound);
+}
+BENCHMARK(BM_AddTask)
+    ->ArgNames({"producers", "workers"})
+    ->ArgsProduct({{1, 2, 4}, {1, 2, 4}})
+    ->UseRealTime();
+
+// Throughput of serial tasks spread over 'state.range(0)' keys, which
+// bounds the parallelism of the 4 workers.
+void
+BM_AddSerialTask(benchmark::State& state)
+{
+  const uint64_t keys = state.range(0);
+  tc::WorkQueue queue("benchmark");
+  if (!queue.Initialize(4).IsOk()) {
+    state.SkipWithError("failed to initialize the queue");
+    return;
+  }
+  std::atomic<size_t> remaining{0};
+  for (auto _ : state) {
+    remaining.store(bench::kItemsPerRound, std::memory_order_relaxed);
+    for (size_t i = 0; i < bench::kItemsPerRound; ++i) {
+      queue.AddSerialTask(i % keys, [&remaining] {
+        remaining.fetch_sub(1, std::memory_order_release);
+      });
+    }
+    bench::WaitForZero(remaining);
+  }
+  state.SetItemsProcessed(state.iterations() * bench::kItemsPerRound);
+}
+BENCHMARK(BM_AddSerialTask)
+    ->ArgName("keys")
+    ->Arg(1)
+    ->Arg(4)
+    ->Arg(64)
+    ->UseRealTime();
+
+// Percentiles of the time from AddTask to the start of the task, for
+// batches of 'state.range(0)' tasks added back to back.
+void
+BM_AddTaskLatency(benchmark::State& state)
+{
+  const size_t batch_size = state.range(0);
+  tc::WorkQueue queue("benchmark");
+  if (!queue.Initialize(2).IsOk()) {
+    state.SkipWithError("failed to initialize the queue");
+    return;
+  }
+  bench::LatencySamples samples(state.max_iterations * batch_size);
+  std::atomic<size_t> remaining{0};
+  for (auto _ : state) {
+    remaining.store(batch_size, std::memory_order_relaxed);
+    for (size_t i = 0; i < batch_size; ++i) {
+      queue.AddTask([&samples, &remaining,
+                     added = std::chrono::steady_clock::now()] {
+        samples.Record(std::chrono::steady_clock::now() - added);
+        remaining.fetch_sub(1, std::memory_order_release);
+      });
+    }
+    bench::WaitForZero(remaining);
+  }
+  samples.Report(state);
+  state.SetItemsProcessed(state.iterations() * batch_size);
+}
+BENCHMARK(BM_AddTaskLatency)
+    ->ArgName("batch_size")
+    ->Arg(1)
+    ->Arg(64)
+    ->Arg(1024)
+    ->UseRealTime();
+
+}  // namespace
@@ -0,0 +1,175 @@
+// Copyright 2026, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace triton { namespace common { namespace bench {
+
+// Number of items moved per benchmark iteration by the throughput
+// benchmarks, large enough to amortize starting a round of ThreadTeam.
+constexpr size_t kItemsPerRound = 1 << 14;
+
+// Share of 'total' items assigned to thread 'index' of 'count' threads.
+inline size_t
+ShareOf(size_t total, size_t index, size_t count)
+{
+  return (total / count) + ((index < (total % count)) ? 1 : 0);
+}
+
+//
+// Fixed set of threads that run 'body' once per call to Run(), so that the
+// threads are started outside of the timed region of a benchmark.
+//
+class ThreadTeam {
+ public:
+  ThreadTeam(size_t size, std::function<void(size_t index)> body)
+      : body_(std::move(body))
+  {
+    for (size_t i = 0; i < size; ++i) {
+      threads_.emplace_back([this, i] { ThreadLoop(i); });
+    }
+  }
+
+  ~ThreadTeam()
+  {
+    {
+      std::lock_guard<std::mutex> lk(mu_);
+      stop_ = true;
+    }
+    start_cv_.notify_all();
+    for (auto& thread : threads_) {
+      thread.join();
+    }
+  }
+
+  ThreadTeam(const ThreadTeam&) = delete;
+  ThreadTeam& operator=(const ThreadTeam&) = delete;
+
+  // Run 'body' on every thread and return once all of them finished.
+  void Run()
+  {
+    std::unique_lock<std::mutex> lk(mu_);
+    running_ = threads_.size();
+    ++round_;
+    start_cv_.notify_all();
+    done_cv_.wait(lk, [this] { return running_ == 0; });
+  }
+
+ private:
+  void ThreadLoop(size_t index)
+  {
+    uint64_t round = 0;
+    while (true) {
+      {
+        std::unique_lock<std::mutex> lk(mu_);
+        start_cv_.wait(
+            lk, [this, round] { return stop_ || (round_ != round); });
+        if (stop_) {
+          return;
+        }
+        round = round_;
+      }
+      body_(index);
+      std::lock_guard<std::mutex> lk(mu_);
+      if (--running_ == 0) {
+        done_cv_.notify_one();
+      }
+    }
+  }
+
+  const std::function<void(size_t)> body_;
+  std::mutex mu_;
+  std::condition_variable start_cv_;
+  std::condition_variable done_cv_;
+  uint64_t round_ = 0;
+  size_t running_ = 0;
+  bool stop_ = false;
+  std::vector<std::thread> threads_;
+};
+
+//
+// Latency samples recorded concurrently, reported as percentile counters
+// of the benchmark. Samples beyond the capacity are dropped.
+//
+class LatencySamples {
+ public:
+  explicit LatencySamples(size_t capacity) : samples_(capacity) {}
+
+  void Record(std::chrono::steady_clock::duration latency)
+  {
+    const size_t index = next_.fetch_add(1, std::memory_order_relaxed);
+    if (index < samples_.size()) {
+      samples_[index] =
+          std::chrono::duration_cast<std::chrono::nanoseconds>(latency)
+              .count();
+    }
+  }
+
+  // Add the p50, p90, p99 and p99.9 latencies, in nanoseconds, to the
+  // counters of 'state'. Must not race with Record().
+  void Report(benchmark::State& state)
+  {
+    const size_t count = std::min(next_.load(), samples_.size());
+    if (count == 0) {
+      return;
+    }
+    std::sort(samples_.begin(), samples_.begin() + count);
+    auto percentile = [this, count](double p) {
+      return static_cast<double>(
+          samples_[std::min(count - 1, static_cast<size_t>(count * p))]);
+    };
+    state.counters["p50_ns"] = percentile(0.5);
+    state.counters["p90_ns"] = percentile(0.9);
+    state.counters["p99_ns"] = percentile(0.99);
+    state.counters["p999_ns"] = percentile(0.999);
+  }
+
+ private:
+  std::vector<int64_t> samples_;
+  std::atomic<size_t> next_{0};
+};
+
+// Block until 'remaining' drops to zero.
+inline void
+WaitForZero(const std::atomic<size_t>& remaining)
+{
+  while (remaining.load(std::memory_order_acquire) != 0) {
+    std::this_thread::yield();
+  }
+}
+
+}}}  // namespace triton::common::bench
@@ -0,0 +1,271 @@
+// Copyright 2026, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <benchmark/benchmark.h>
+#include <dirent.h>
+#include <sys/syscall.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <sstream>
+#include <string>
+
+// Defined but not used
+#define TRITONJSON_STATUSTYPE uint8_t
+#define TRITONJSON_STATUSRETURN(M)
+#define TRITONJSON_STATUSSUCCESS 0
+
+#include "triton/common/logging.h"
+#include "triton/common/triton_json.h"
+
+namespace tc = triton::common;
+
+namespace {
+
+// Formats records the way LogMessage did before it used per-thread
+// buffers: a copied path, string streams for the message and the record,
+// iomanip for the timestamp and an escaped copy of the message. Serves as
+// the baseline.
+class StreamLogMessage {
+ public:
+  StreamLogMessage(const char* file, int line, tc::Logger::Level level)
+      : path_(file), line_(line), level_(level),
+        pid_(static_cast<uint32_t>(getpid()))
+  {
+    gettimeofday(&timestamp_, NULL);
+    size_t path_start = path_.rfind('/');
+    if (path_start != std::string::npos) {
+      path_ = path_.substr(path_start + 1, std::string::npos);
+    }
+  }
+
+  ~StreamLogMessage()
+  {
+    std::stringstream log_record;
+    struct tm tm_time;
+    gmtime_r(((time_t*)&(timestamp_.tv_sec)), &tm_time);
+    log_record << tc::Logger::LEVEL_NAMES[static_cast<uint8_t>(level_)]
+               << std::setfill('0') << std::setw(2) << (tm_time.tm_mon + 1)
+               << std::setw(2) << tm_time.tm_mday << ' ' << std::setw(2)
+               << tm_time.tm_hour << ':' << std::setw(2) << tm_time.tm_min
+               << ':' << std::setw(2) << tm_time.tm_sec << '.'
+               << std::setw(6) << timestamp_.tv_usec;
+    log_record << ' ' << pid_ << ' ' << path_ << ':' << line_ << "] ";
+    log_record << tc::TritonJson::SerializeString(message_.str());
+    tc::gLogger_.Log(log_record.str(), level_);
+  }
+
+  std::stringstream& stream() { return message_; }
+
+ private:
+  std::string path_;
+  const int line_;
+  const tc::Logger::Level level_;
+  const uint32_t pid_;
+  struct timeval timestamp_;
+  std::stringstream message_;
+};
+
+// Formats the same JSON record as the kJSON format by building a
+// TritonJson document per record. Serves as the baseline of the JSON
+// format.
+class DocumentLogMessage {
+ public:
+  DocumentLogMessage(const char* file, int line, tc::Logger::Level level)
+      : file_(tc::LogBasename(file)), line_(line), level_(level)
+  {
+    gettimeofday(&timestamp_, NULL);
+  }
+
+  ~DocumentLogMessage()
+  {
+    static const char* kLevelNames[] = {"ERROR", "WARNING", "INFO"};
+    tc::TritonJson::Value record(tc::TritonJson::ValueType::OBJECT);
+    record.AddStringRef("level", kLevelNames[static_cast<uint8_t>(level_)]);
+    record.AddUInt(
+        "timestamp_us", static_cast<uint64_t>(timestamp_.tv_sec) * 1000000 +
+                            timestamp_.tv_usec);
+    record.AddUInt("pid", getpid());
+    record.AddUInt("tid", syscall(SYS_gettid));
+    record.AddStringRef("file", file_);
+    record.AddInt("line", line_);
+    record.AddBool("verbose", false);
+    record.AddString("message", message_.str());
+    tc::TritonJson::WriteBuffer buffer;
+    record.Write(&buffer);
+    tc::gLogger_.Log(buffer.Contents(), level_);
+  }
+
+  std::stringstream& stream() { return message_; }
+
+ private:
+  const char* file_;
+  const int line_;
+  const tc::Logger::Level level_;
+  struct timeval timestamp_;
+  std::stringstream message_;
+};
+
+// Records are written to /dev/null so that both variants pay the same,
+// small, output cost.
+class NullSink {
+ public:
+  NullSink() { tc::gLogger_.SetLogFile("/dev/null"); }
+  ~NullSink() { tc::gLogger_.SetLogFile(""); }
+};
+
+// Remove 'directory' and the files in it.
+void
+RemoveDirectory(const std::string& directory)
+{
+  DIR* dir = opendir(directory.c_str());
+  if (dir != nullptr) {
+    for (struct dirent* entry; (entry = readdir(dir)) != nullptr;) {
+      std::remove((directory + "/" + entry->d_name).c_str());
+    }
+    closedir(dir);
+  }
+  std::remove(directory.c_str());
+}
+
+void
+BM_StreamLogMessage(benchmark::State& state)
+{
+  NullSink sink;
+  int request = 0;
+  for (auto _ : state) {
+    StreamLogMessage(__FILE__, __LINE__, tc::Logger::Level::kINFO).stream()
+        << "request " << ++request << " completed with \"status\" "
+        << 3.25;
+  }
+}
+BENCHMARK(BM_StreamLogMessage);
+
+void
+BM_LogMessage(benchmark::State& state)
+{
+  NullSink sink;
+  int request = 0;
+  for (auto _ : state) {
+    tc::LogMessage(TRITON_LOG_FILE, __LINE__, tc::Logger::Level::kINFO)
+            .stream()
+        << "request " << ++request << " completed with \"status\" "
+        << 3.25;
+  }
+}
+BENCHMARK(BM_LogMessage);
+
+void
+BM_DocumentLogMessageJson(benchmark::State& state)
+{
+  NullSink sink;
+  int request = 0;
+  for (auto _ : state) {
+    DocumentLogMessage(__FILE__, __LINE__, tc::Logger::Level::kINFO).stream()
+        << "request " << ++request << " completed with \"status\" "
+        << 3.25;
+  }
+}
+BENCHMARK(BM_DocumentLogMessageJson);
+
+void
+BM_LogMessageJson(benchmark::State& state)
+{
+  NullSink sink;
+  tc::gLogger_.SetLogFormat(tc::Logger::Format::kJSON);
+  int request = 0;
+  for (auto _ : state) {
+    tc::LogMessage(TRITON_LOG_FILE, __LINE__, tc::Logger::Level::kINFO)
+            .stream()
+        << "request " << ++request << " completed with \"status\" "
+        << 3.25;
+  }
+  tc::gLogger_.SetLogFormat(tc::Logger::Format::kDEFAULT);
+}
+BENCHMARK(BM_LogMessageJson);
+
+// Cost of a LOG_VERBOSE_FMT record formatted as text, and written to the
+// binary log instead, which stores the arguments without formatting them.
+void
+BM_LogVerboseFormat(benchmark::State& state)
+{
+  static tc::LogFormatSite site(TRITON_LOG_FILE, __LINE__);
+  NullSink sink;
+  int request = 0;
+  for (auto _ : state) {
+    tc::LogVerboseFormat(
+        site, "request {} completed with \"status\" {}", ++request, 3.25);
+  }
+}
+BENCHMARK(BM_LogVerboseFormat);
+
+void
+BM_LogVerboseFormatBinary(benchmark::State& state)
+{
+  static tc::LogFormatSite site(TRITON_LOG_FILE, __LINE__);
+  char directory[] = "/tmp/triton_binary_log_XXXXXX";
+  if ((mkdtemp(directory) == nullptr) ||
+      !tc::gLogger_.SetBinaryLog(directory).empty()) {
+    state.SkipWithError("Failed to enable the binary log");
+    return;
+  }
+  int request = 0;
+  for (auto _ : state) {
+    tc::LogVerboseFormat(
+        site, "request {} completed with \"status\" {}", ++request, 3.25);
+  }
+  tc::gLogger_.SetBinaryLog("");
+  RemoveDirectory(directory);
+}
+BENCHMARK(BM_LogVerboseFormatBinary);
+
+// Cost of a record dropped by the rate limit of its call site, as with
+// LOG_WARNING_EVERY_SECONDS, for threads sharing the call site.
+void
+BM_LogSiteRateLimited(benchmark::State& state)
+{
+  static tc::LogSite site;
+  const int64_t hour_ns = 3600LL * 1000000000LL;
+  site.Allow(hour_ns, 1);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(site.Allow(hour_ns, 1));
+  }
+}
+BENCHMARK(BM_LogSiteRateLimited)->ThreadRange(1, 4);
+
+// Cost of a record dropped by LOG_WARNING_EVERY_N.
+void
+BM_LogSiteEveryN(benchmark::State& state)
+{
+  static tc::LogSite site;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(site.EveryN(1000));
+  }
+}
+BENCHMARK(BM_LogSiteEveryN)->ThreadRange(1, 4);
+
+}  // namespace
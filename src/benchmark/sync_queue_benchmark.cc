@@ -0,0 +1,181 @@
+// Copyright 2026, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "benchmark_util.h"
+#include "triton/common/lock_free_sync_queue.h"
+#include "triton/common/sync_queue.h"
+
+namespace tc = triton::common;
+namespace bench = triton::common::bench;
+
+namespace {
+
+constexpr size_t kBoundedCapacity = 1024;
+constexpr size_t kBatchSize = 64;
+
+// Moves 'kItemsPerRound' items per iteration from 'state.range(0)'
+// producers to 'state.range(1)' consumers through 'queue'.
+template <typename Queue>
+void
+RunProducersConsumers(benchmark::State& state, Queue& queue)
+{
+  const size_t producers = state.range(0);
+  const size_t consumers = state.range(1);
+  bench::ThreadTeam team(producers + consumers, [&](size_t index) {
+    if (index < producers) {
+      const size_t count =
+          bench::ShareOf(bench::kItemsPerRound, index, producers);
+      for (size_t i = 0; i < count; ++i) {
+        queue.Put(static_cast<int>(i));
+      }
+    } else {
+      const size_t count = bench::ShareOf(
+          bench::kItemsPerRound, index - producers, consumers);
+      for (size_t i = 0; i < count; ++i) {
+        benchmark::DoNotOptimize(queue.Get());
+      }
+    }
+  });
+  for (auto _ : state) {
+    team.Run();
+  }
+  state.SetItemsProcessed(state.iterations() * bench::kItemsPerRound);
+}
+
+void
+ProducerConsumerArgs(benchmark::internal::Benchmark* b)
+{
+  b->ArgNames({"producers", "consumers"});
+  for (const int producers : {1, 2, 4}) {
+    for (const int consumers : {1, 2, 4}) {
+      b->Args({producers, consumers});
+    }
+  }
+  b->UseRealTime();
+}
+
+void
+BM_SyncQueue(benchmark::State& state)
+{
+  tc::SyncQueue<int> queue;
+  RunProducersConsumers(state, queue);
+}
+BENCHMARK(BM_SyncQueue)->Apply(ProducerConsumerArgs);
+
+void
+BM_BoundedSyncQueue(benchmark::State& state)
+{
+  tc::SyncQueue<int> queue(kBoundedCapacity);
+  RunProducersConsumers(state, queue);
+}
+BENCHMARK(BM_BoundedSyncQueue)->Apply(ProducerConsumerArgs);
+
+void
+BM_LockFreeSyncQueue(benchmark::State& state)
+{
+  tc::LockFreeSyncQueue<int> queue(kBoundedCapacity);
+  RunProducersConsumers(state, queue);
+}
+BENCHMARK(BM_LockFreeSyncQueue)->Apply(ProducerConsumerArgs);
+
+// Same as BM_BoundedSyncQueue but with PutBatch and GetBatch, which take
+// the lock once per batch.
+void
+BM_BoundedSyncQueueBatch(benchmark::State& state)
+{
+  tc::SyncQueue<int> queue(kBoundedCapacity);
+  const size_t producers = state.range(0);
+  const size_t consumers = state.range(1);
+  bench::ThreadTeam team(producers + consumers, [&](size_t index) {
+    std::vector<int> batch;
+    if (index < producers) {
+      size_t count = bench::ShareOf(bench::kItemsPerRound, index, producers);
+      while (count != 0) {
+        batch.assign(std::min(count, kBatchSize), 0);
+        count -= queue.PutBatch(batch);
+      }
+    } else {
+      size_t count = bench::ShareOf(
+          bench::kItemsPerRound, index - producers, consumers);
+      while (count != 0) {
+        batch.clear();
+        count -= queue.GetBatch(
+            std::min(count, kBatchSize), std::chrono::seconds(10), &batch);
+      }
+    }
+  });
+  for (auto _ : state) {
+    team.Run();
+  }
+  state.SetItemsProcessed(state.iterations() * bench::kItemsPerRound);
+}
+BENCHMARK(BM_BoundedSyncQueueBatch)->Apply(ProducerConsumerArgs);
+
+// Time from Put to the return of Get on a consumer blocked on an empty
+// queue, i.e. the cost of waking a waiting consumer.
+template <typename Queue>
+void
+RunHandOffLatency(benchmark::State& state, Queue& queue)
+{
+  bench::LatencySamples samples(state.max_iterations);
+  std::thread consumer([&] {
+    for (benchmark::IterationCount i = 0; i < state.max_iterations; ++i) {
+      const auto sent = queue.Get();
+      samples.Record(std::chrono::steady_clock::now() - sent);
+    }
+  });
+  for (auto _ : state) {
+    queue.Put(std::chrono::steady_clock::now());
+    // Let the consumer block again
+    std::this_thread::sleep_for(std::chrono::microseconds(50));
+  }
+  consumer.join();
+  samples.Report(state);
+}
+
+void
+BM_SyncQueueHandOffLatency(benchmark::State& state)
+{
+  tc::SyncQueue<std::chrono::steady_clock::time_point> queue;
+  RunHandOffLatency(state, queue);
+}
+BENCHMARK(BM_SyncQueueHandOffLatency)->UseRealTime();
+
+void
+BM_LockFreeSyncQueueHandOffLatency(benchmark::State& state)
+{
+  tc::LockFreeSyncQueue<std::chrono::steady_clock::time_point> queue;
+  RunHandOffLatency(state, queue);
+}
+BENCHMARK(BM_LockFreeSyncQueueHandOffLatency)->UseRealTime();
+
+}  // namespace
@@ -0,0 +1,274 @@
+// Copyright 2026, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "benchmark_util.h"
+#include "triton/common/thread_pool.h"
+
+namespace tc = triton::common;
+namespace bench = triton::common::bench;
+
+namespace {
+
+// Minimal pool idling the way ThreadPool did before it parked workers on
+// an event count: workers block on a condition variable and every enqueue
+// signals it, whether or not a worker is waiting. Serves as the baseline.
+class ConditionVariablePool {
+ public:
+  explicit ConditionVariablePool(size_t thread_count)
+  {
+    for (size_t i = 0; i < thread_count; ++i) {
+      workers_.emplace_back([this] { WorkerLoop(); });
+    }
+  }
+
+  ~ConditionVariablePool()
+  {
+    {
+      std::lock_guard<std::mutex> lk(mu_);
+      stop_ = true;
+    }
+    cv_.notify_all();
+    for (auto& worker : workers_) {
+      worker.join();
+    }
+  }
+
+  bool Enqueue(tc::ThreadPool::Task&& task)
+  {
+    {
+      std::lock_guard<std::mutex> lk(mu_);
+      tasks_.push_back(std::move(task));
+    }
+    cv_.notify_one();
+    return true;
+  }
+
+ private:
+  void WorkerLoop()
+  {
+    while (true) {
+      tc::ThreadPool::Task task;
+      {
+        std::unique_lock<std::mutex> lk(mu_);
+        cv_.wait(lk, [this] { return stop_ || !tasks_.empty(); });
+        if (tasks_.empty()) {
+          return;
+        }
+        task = std::move(tasks_.front());
+        tasks_.pop_front();
+      }
+      task();
+    }
+  }
+
+  std::mutex mu_;
+  std::condition_variable cv_;
+  std::deque<tc::ThreadPool::Task> tasks_;
+  bool stop_ = false;
+  std::vector<std::thread> workers_;
+};
+
+tc::ThreadPool::Options
+PoolOptions(const benchmark::State& state)
+{
+  tc::ThreadPool::Options options;
+  options.thread_count = 2;
+  options.spin_count = static_cast<uint32_t>(state.range(0));
+  return options;
+}
+
+// Round trip of a single task through an otherwise idle pool, which is
+// dominated by the cost of waking a worker.
+template <typename Pool>
+void
+RunPingPong(benchmark::State& state, Pool& pool)
+{
+  std::atomic<bool> done{false};
+  for (auto _ : state) {
+    done.store(false, std::memory_order_relaxed);
+    pool.Enqueue([&done] { done.store(true, std::memory_order_release); });
+    while (!done.load(std::memory_order_acquire)) {
+      std::this_thread::yield();
+    }
+  }
+}
+
+// Bursts of short tasks, where workers going idle between tasks of the
+// same burst is what spinning avoids.
+template <typename Pool>
+void
+RunBursts(benchmark::State& state, Pool& pool)
+{
+  constexpr size_t kBurstSize = 256;
+  std::atomic<size_t> remaining{0};
+  for (auto _ : state) {
+    remaining.store(kBurstSize, std::memory_order_relaxed);
+    for (size_t i = 0; i < kBurstSize; ++i) {
+      pool.Enqueue(
+          [&remaining] { remaining.fetch_sub(1, std::memory_order_release); });
+    }
+    while (remaining.load(std::memory_order_acquire) != 0) {
+      std::this_thread::yield();
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kBurstSize);
+}
+
+void
+BM_PingPongConditionVariable(benchmark::State& state)
+{
+  ConditionVariablePool pool(2);
+  RunPingPong(state, pool);
+}
+BENCHMARK(BM_PingPongConditionVariable)->UseRealTime();
+
+void
+BM_PingPongThreadPool(benchmark::State& state)
+{
+  tc::ThreadPool pool(PoolOptions(state));
+  RunPingPong(state, pool);
+}
+BENCHMARK(BM_PingPongThreadPool)
+    ->ArgName("spin_count")
+    ->Arg(0)
+    ->Arg(128)
+    ->Arg(1024)
+    ->UseRealTime();
+
+void
+BM_BurstsConditionVariable(benchmark::State& state)
+{
+  ConditionVariablePool pool(2);
+  RunBursts(state, pool);
+}
+BENCHMARK(BM_BurstsConditionVariable)->UseRealTime();
+
+void
+BM_BurstsThreadPool(benchmark::State& state)
+{
+  tc::ThreadPool pool(PoolOptions(state));
+  RunBursts(state, pool);
+}
+BENCHMARK(BM_BurstsThreadPool)
+    ->ArgName("spin_count")
+    ->Arg(0)
+    ->Arg(128)
+    ->Arg(1024)
+    ->UseRealTime();
+
+// Throughput of trivial tasks enqueued by 'state.range(0)' producers to a
+// pool of 'state.range(1)' workers.
+void
+BM_EnqueueThroughput(benchmark::State& state)
+{
+  const size_t producers = state.range(0);
+  tc::ThreadPool pool(state.range(1));
+  std::atomic<size_t> remaining{0};
+  bench::ThreadTeam team(producers, [&](size_t index) {
+    const size_t count =
+        bench::ShareOf(bench::kItemsPerRound, index, producers);
+    for (size_t i = 0; i < count; ++i) {
+      pool.Enqueue(
+          [&remaining] { remaining.fetch_sub(1, std::memory_order_release); });
+    }
+  });
+  for (auto _ : state) {
+    remaining.store(bench::kItemsPerRound, std::memory_order_relaxed);
+    team.Run();
+    bench::WaitForZero(remaining);
+  }
+  state.SetItemsProcessed(state.iterations() * bench::kItemsPerRound);
+}
+BENCHMARK(BM_EnqueueThroughput)
+    ->ArgNames({"producers", "workers"})
+    ->ArgsProduct({{1, 2, 4}, {1, 2, 4}})
+    ->UseRealTime();
+
+// Percentiles of the time from Enqueue to the start of the task, for
+// batches of 'state.range(0)' tasks enqueued back to back.
+void
+BM_TaskLatency(benchmark::State& state)
+{
+  const size_t batch_size = state.range(0);
+  tc::ThreadPool pool(2);
+  bench::LatencySamples samples(state.max_iterations * batch_size);
+  std::atomic<size_t> remaining{0};
+  for (auto _ : state) {
+    remaining.store(batch_size, std::memory_order_relaxed);
+    for (size_t i = 0; i < batch_size; ++i) {
+      pool.Enqueue([&samples, &remaining,
+                    enqueued = std::chrono::steady_clock::now()] {
+        samples.Record(std::chrono::steady_clock::now() - enqueued);
+        remaining.fetch_sub(1, std::memory_order_release);
+      });
+    }
+    bench::WaitForZero(remaining);
+  }
+  samples.Report(state);
+  state.SetItemsProcessed(state.iterations() * batch_size);
+}
+BENCHMARK(BM_TaskLatency)
+    ->ArgName("batch_size")
+    ->Arg(1)
+    ->Arg(64)
+    ->Arg(1024)
+    ->UseRealTime();
+
+// Round trip of a single task through a pool whose workers are parked,
+// i.e. past their spin phase. The pauses add a fixed overhead of the
+// timer itself.
+void
+BM_WakeParkedWorker(benchmark::State& state)
+{
+  tc::ThreadPool pool(PoolOptions(state));
+  std::atomic<size_t> remaining{0};
+  for (auto _ : state) {
+    state.PauseTiming();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    remaining.store(1, std::memory_order_relaxed);
+    state.ResumeTiming();
+    pool.Enqueue(
+        [&remaining] { remaining.fetch_sub(1, std::memory_order_release); });
+    bench::WaitForZero(remaining);
+  }
+}
+BENCHMARK(BM_WakeParkedWorker)
+    ->ArgName("spin_count")
+    ->Arg(0)
+    ->Arg(128)
+    ->UseRealTime();
+
+}  // namespace
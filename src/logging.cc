@@ -25,23 +25,935 @@
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <algorithm>
-#include <iomanip>
+#include <climits>
+#include <condition_variable>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
 #include <iostream>
+#include <new>
+#include <string_view>
+#include <thread>
 
-// Defined but not used
-#define TRITONJSON_STATUSTYPE uint8_t
-#define TRITONJSON_STATUSRETURN(M)
-#define TRITONJSON_STATUSSUCCESS 0
+#ifndef _WIN32
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#endif
+
+#ifdef TRITON_ENABLE_LOG_GZIP
+#include <zlib.h>
+#endif
+#ifdef TRITON_ENABLE_LOG_ZSTD
+#include <zstd.h>
+#endif
 
 #include "triton/common/logging.h"
-#include "triton/common/triton_json.h"
+#include "triton/common/lock_free_sync_queue.h"
 
 namespace triton { namespace common {
 
 namespace {
 constexpr uint64_t kMicrosecondsPerSecond = 1000000ULL;
+// Maximum number of records written at once by the asynchronous writer.
+constexpr size_t kAsyncBatchSize = 64;
+// Records up to this size, newline included, are stored in the ring
+// itself, longer ones on the heap.
+constexpr size_t kAsyncInlineSize = 256;
+// Names of the log levels in JSON records.
+constexpr const char* kJsonLevelNames[] = {"ERROR", "WARNING", "INFO"};
+
+// Ring sizes accepted by Logger::SetBinaryLog(), the largest one such that
+// record sizes fit in 32 bits.
+constexpr size_t kBinaryMinRingSize = 4096;
+constexpr size_t kBinaryMaxRingSize = UINT32_MAX & ~size_t(7);
+
+#ifndef _WIN32
+// Write all of 'data' to 'fd'. Returns false on failure.
+bool
+WriteAll(int fd, const std::string& data)
+{
+  size_t written = 0;
+  while (written < data.size()) {
+    const ssize_t res = write(fd, data.data() + written, data.size() - written);
+    if (res < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    written += res;
+  }
+  return true;
+}
+
+//
+// Ring file of the binary log mapped by a thread, see binary_log.h. Only
+// the owning thread writes to it.
+//
+class LogBinaryRing {
+ public:
+  LogBinaryRing() = default;
+  ~LogBinaryRing() { Unmap(); }
+
+  LogBinaryRing(const LogBinaryRing&) = delete;
+  LogBinaryRing& operator=(const LogBinaryRing&) = delete;
+
+  // Binary log session of the ring file.
+  uint32_t Session() const { return session_; }
+
+  // Replace the ring file with a new one of 'capacity' bytes in
+  // 'directory' for 'session'. The ring stays unmapped if 'directory' is
+  // empty or the file can not be created.
+  void Map(
+      const std::string& directory, size_t capacity, uint32_t session,
+      uint64_t tid)
+  {
+    Unmap();
+    session_ = session;
+    if (directory.empty()) {
+      return;
+    }
+    const uint32_t pid = static_cast<uint32_t>(getpid());
+    const std::string path = directory + "/triton." + std::to_string(pid) +
+                             "." + std::to_string(tid) + ".blog";
+    const int fd =
+        open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd == -1) {
+      return;
+    }
+    // Allocated up front, a write to a sparse page of a full file system
+    // would raise SIGBUS
+    const size_t size = sizeof(LogBinaryRingHeader) + capacity;
+    void* mapped =
+        (posix_fallocate(fd, 0, size) == 0)
+            ? mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)
+            : MAP_FAILED;
+    close(fd);
+    if (mapped == MAP_FAILED) {
+      return;
+    }
+    header_ = new (mapped) LogBinaryRingHeader;
+    std::memcpy(header_->magic, kLogBinaryRingMagic, sizeof(header_->magic));
+    header_->version = kLogBinaryVersion;
+    header_->pid = pid;
+    header_->tid = tid;
+    header_->capacity = capacity;
+    header_->head.store(0, std::memory_order_relaxed);
+    header_->tail.store(0, std::memory_order_relaxed);
+    data_ = static_cast<char*>(mapped) + sizeof(LogBinaryRingHeader);
+    mapped_size_ = size;
+  }
+
+  // Append a record, overwriting the oldest ones as needed. Returns false
+  // if the ring is unmapped or too small for the record.
+  bool Write(
+      uint32_t site, uint64_t timestamp_ns, const LogBinaryValue* values,
+      size_t count)
+  {
+    if (header_ == nullptr) {
+      return false;
+    }
+    size_t size = sizeof(LogBinaryRecordHeader);
+    for (size_t i = 0; i < count; ++i) {
+      size += values[i].Size();
+    }
+    size = (size + 7) & ~size_t(7);
+    const uint64_t capacity = header_->capacity;
+    if (size > capacity) {
+      return false;
+    }
+    uint64_t head = header_->head.load(std::memory_order_relaxed);
+    const uint64_t offset = head % capacity;
+    if (offset + size > capacity) {
+      // Pad the end of the ring, records are contiguous
+      const uint32_t padding[2] = {
+          static_cast<uint32_t>(capacity - offset), kLogBinaryPaddingSite};
+      Reserve(head, padding[0]);
+      std::memcpy(data_ + offset, padding, sizeof(padding));
+      head += padding[0];
+    }
+    Reserve(head, size);
+    char* out = data_ + (head % capacity);
+    const LogBinaryRecordHeader record{
+        static_cast<uint32_t>(size), site, timestamp_ns};
+    std::memcpy(out, &record, sizeof(record));
+    out += sizeof(record);
+    for (size_t i = 0; i < count; ++i) {
+      out = values[i].Write(out);
+    }
+    header_->head.store(head + size, std::memory_order_release);
+    return true;
+  }
+
+ private:
+  // Move the tail past the records overwritten by 'size' bytes at 'head'.
+  void Reserve(uint64_t head, uint64_t size)
+  {
+    const uint64_t capacity = header_->capacity;
+    uint64_t tail = header_->tail.load(std::memory_order_relaxed);
+    if (head + size - tail <= capacity) {
+      return;
+    }
+    do {
+      uint32_t record_size;
+      std::memcpy(&record_size, data_ + (tail % capacity), sizeof(uint32_t));
+      tail += record_size;
+    } while (head + size - tail > capacity);
+    header_->tail.store(tail, std::memory_order_release);
+  }
+
+  void Unmap()
+  {
+    if (header_ != nullptr) {
+      munmap(header_, mapped_size_);
+      header_ = nullptr;
+    }
+  }
+
+  uint32_t session_ = 0;
+  LogBinaryRingHeader* header_ = nullptr;
+  char* data_ = nullptr;
+  size_t mapped_size_ = 0;
+};
+#endif  // !_WIN32
+
+// LOG_VERBOSE_FMT call sites registered with the binary log, by id minus
+// one, and the sites file of the binary log, -1 if none.
+struct LogFormatSites {
+  struct Entry {
+    const char* file;
+    int line;
+    const char* format;
+  };
+  std::mutex mutex;
+  std::vector<Entry> entries;
+  int fd = -1;
+};
+
+LogFormatSites&
+FormatSites()
+{
+  static LogFormatSites sites;
+  return sites;
+}
+
+#ifndef _WIN32
+// Append the entry of call site 'id' of the sites file to 'out'.
+void
+AppendSiteEntry(
+    std::string* out, uint32_t id, const LogFormatSites::Entry& entry)
+{
+  auto append_u32 = [out](uint32_t value) {
+    out->append(reinterpret_cast<const char*>(&value), sizeof(value));
+  };
+  append_u32(id);
+  append_u32(static_cast<uint32_t>(entry.line));
+  append_u32(static_cast<uint32_t>(std::strlen(entry.file)));
+  out->append(entry.file);
+  append_u32(static_cast<uint32_t>(std::strlen(entry.format)));
+  out->append(entry.format);
+}
+#endif  // !_WIN32
+
+// Per-thread buffers of LogMessage, reused across records.
+struct LogBuffers {
+  std::stringstream stream;
+  // Whether 'stream' is used by a message of this thread.
+  bool stream_in_use = false;
+  std::string message;
+  std::string record;
+  // Identifier of the thread, 0 until looked up.
+  uint64_t tid = 0;
+#ifndef _WIN32
+  // Broken-down time of 'tm_second', records of the same second are common.
+  time_t tm_second = -1;
+  struct tm tm_time;
+  // Ring file of the binary log, see Logger::SetBinaryLog().
+  LogBinaryRing binary_ring;
+#endif
+};
+
+LogBuffers&
+ThreadLogBuffers()
+{
+  thread_local LogBuffers buffers;
+  return buffers;
+}
+
+// Identifier of the calling thread as shown by the OS tools.
+uint64_t
+ThreadId(LogBuffers& buffers)
+{
+  if (buffers.tid == 0) {
+#ifdef _WIN32
+    buffers.tid = GetCurrentThreadId();
+#else
+    buffers.tid = static_cast<uint64_t>(syscall(SYS_gettid));
+#endif
+  }
+  return buffers.tid;
+}
+
+// Copy the content of 'stream' to 'out', reusing its capacity.
+void
+ReadStream(std::stringstream& stream, std::string* out)
+{
+  std::stringbuf* buf = stream.rdbuf();
+  const std::streamoff size =
+      buf->pubseekoff(0, std::ios_base::cur, std::ios_base::out);
+  out->resize((size > 0) ? size : 0);
+  if (size > 0) {
+    buf->pubseekpos(0, std::ios_base::in);
+    buf->sgetn(&(*out)[0], size);
+  }
+}
+
+// Whether 'name' matches 'pattern', where '*' matches any sequence of
+// characters and '?' any single character.
+bool
+GlobMatch(const char* pattern, const char* name, size_t name_size)
+{
+  const char* star = nullptr;
+  size_t star_name = 0;
+  size_t i = 0;
+  while (i < name_size) {
+    if ((*pattern == '?') || ((*pattern != '\0') && (*pattern == name[i]))) {
+      ++pattern;
+      ++i;
+    } else if (*pattern == '*') {
+      // Match nothing first, retry with one more character on mismatch
+      star = pattern++;
+      star_name = i;
+    } else if (star != nullptr) {
+      pattern = star + 1;
+      i = ++star_name;
+    } else {
+      return false;
+    }
+  }
+  while (*pattern == '*') {
+    ++pattern;
+  }
+  return *pattern == '\0';
+}
+
+// Append 'value' in decimal, zero-padded to at least 'width' digits.
+void
+AppendDecimal(std::string* out, uint64_t value, size_t width = 1)
+{
+  char digits[20];
+  size_t count = 0;
+  do {
+    digits[count++] = static_cast<char>('0' + (value % 10));
+    value /= 10;
+  } while (value != 0);
+  if (width > count) {
+    out->append(width - count, '0');
+  }
+  while (count != 0) {
+    out->push_back(digits[--count]);
+  }
+}
+
+// Append 'str' as a quoted JSON string. Produces the same output as
+// TritonJson::SerializeString without building an intermediate string.
+void
+AppendEscaped(std::string* out, std::string_view str)
+{
+  static constexpr char kHexDigits[] = "0123456789ABCDEF";
+  out->push_back('"');
+  for (const char* c = str.data(); c != str.data() + str.size(); ++c) {
+    const unsigned char u = static_cast<unsigned char>(*c);
+    switch (u) {
+      case '"':
+        out->append("\\\"");
+        break;
+      case '\\':
+        out->append("\\\\");
+        break;
+      case '\b':
+        out->append("\\b");
+        break;
+      case '\f':
+        out->append("\\f");
+        break;
+      case '\n':
+        out->append("\\n");
+        break;
+      case '\r':
+        out->append("\\r");
+        break;
+      case '\t':
+        out->append("\\t");
+        break;
+      default:
+        if (u < 0x20) {
+          out->append("\\u00");
+          out->push_back(kHexDigits[u >> 4]);
+          out->push_back(kHexDigits[u & 0xF]);
+        } else {
+          out->push_back(*c);
+        }
+        break;
+    }
+  }
+  out->push_back('"');
+}
+
+// Suffix of the rotated log files compressed with 'compression'.
+const char*
+CompressionSuffix(Logger::Compression compression)
+{
+  switch (compression) {
+    case Logger::Compression::kGZIP:
+      return ".gz";
+    case Logger::Compression::kZSTD:
+      return ".zst";
+    default:
+      return "";
+  }
+}
+
+#ifdef TRITON_ENABLE_LOG_GZIP
+// Compress 'src' to 'dst' with gzip. Returns false and removes 'dst' on
+// failure.
+bool
+GzipFile(const std::string& src, const std::string& dst)
+{
+  FILE* in = std::fopen(src.c_str(), "rb");
+  if (in == nullptr) {
+    return false;
+  }
+  gzFile out = gzopen(dst.c_str(), "wb");
+  bool success = (out != nullptr);
+  std::vector<char> buffer(1 << 16);
+  while (success) {
+    const size_t size = std::fread(buffer.data(), 1, buffer.size(), in);
+    if (size == 0) {
+      success = !std::ferror(in);
+      break;
+    }
+    success = (gzwrite(out, buffer.data(), size) == static_cast<int>(size));
+  }
+  std::fclose(in);
+  if ((out != nullptr) && (gzclose(out) != Z_OK)) {
+    success = false;
+  }
+  if (!success) {
+    std::remove(dst.c_str());
+  }
+  return success;
+}
+#endif  // TRITON_ENABLE_LOG_GZIP
+
+#ifdef TRITON_ENABLE_LOG_ZSTD
+// Compress 'src' to 'dst' with zstd. Returns false and removes 'dst' on
+// failure.
+bool
+ZstdFile(const std::string& src, const std::string& dst)
+{
+  FILE* in = std::fopen(src.c_str(), "rb");
+  if (in == nullptr) {
+    return false;
+  }
+  FILE* out = std::fopen(dst.c_str(), "wb");
+  ZSTD_CCtx* context = ZSTD_createCCtx();
+  bool success = (out != nullptr) && (context != nullptr);
+  std::vector<char> in_buffer(ZSTD_CStreamInSize());
+  std::vector<char> out_buffer(ZSTD_CStreamOutSize());
+  bool last = false;
+  while (success && !last) {
+    const size_t size =
+        std::fread(in_buffer.data(), 1, in_buffer.size(), in);
+    last = (size < in_buffer.size());
+    if (last && std::ferror(in)) {
+      success = false;
+      break;
+    }
+    ZSTD_inBuffer input{in_buffer.data(), size, 0};
+    const ZSTD_EndDirective mode = last ? ZSTD_e_end : ZSTD_e_continue;
+    size_t remaining = 0;
+    do {
+      ZSTD_outBuffer output{out_buffer.data(), out_buffer.size(), 0};
+      remaining = ZSTD_compressStream2(context, &output, &input, mode);
+      success = !ZSTD_isError(remaining) &&
+                (std::fwrite(out_buffer.data(), 1, output.pos, out) ==
+                 output.pos);
+      // The last chunk is done once flushed, the others once consumed
+    } while (success && (last ? (remaining != 0) : (input.pos != size)));
+  }
+  ZSTD_freeCCtx(context);
+  std::fclose(in);
+  if ((out != nullptr) && (std::fclose(out) != 0)) {
+    success = false;
+  }
+  if (!success) {
+    std::remove(dst.c_str());
+  }
+  return success;
+}
+#endif  // TRITON_ENABLE_LOG_ZSTD
+
+// Report 'error' of the logger itself, if any, where there is no caller to
+// return it to.
+void
+ReportError(const std::string& error)
+{
+  if (!error.empty()) {
+    std::cerr << error << std::flush;
+  }
+}
+
+#ifndef _WIN32
+// Write end of the pipe of the log rotator while SIGHUP rotates the log
+// file, else -1.
+std::atomic<int> sighup_fd{-1};
+// Guarded by the logger 'mutex_'
+bool sighup_installed = false;
+struct sigaction previous_sighup_action;
+
+void
+HandleSighup(int)
+{
+  const int fd = sighup_fd.load();
+  if (fd != -1) {
+    const char request = 'r';
+    // A full pipe already holds pending requests
+    const ssize_t res = write(fd, &request, 1);
+    (void)res;
+  }
+}
+#endif  // !_WIN32
 }  // namespace
 
+//
+// Background writer of the asynchronous mode. Logging threads push
+// formatted records to a LockFreeSyncQueue and the writer thread pops them
+// in batches of up to 'kAsyncBatchSize', written with one writev() per run
+// of records to the same output.
+//
+class Logger::AsyncWriter {
+ public:
+  AsyncWriter(Logger* logger, size_t capacity, OverflowPolicy policy)
+      : logger_(logger), policy_(policy), ring_(capacity),
+        writer_(&AsyncWriter::WriterLoop, this)
+  {
+  }
+
+  // Write the pending records and stop the writer thread.
+  ~AsyncWriter()
+  {
+    stop_ = true;
+    // Wake the writer with an empty record
+    ring_.Put(Record());
+    writer_.join();
+#ifndef _WIN32
+    if (file_fd_ != -1) {
+      close(file_fd_);
+    }
+#endif
+  }
+
+  void Push(const std::string& msg, Level level)
+  {
+    // Counted before the record is visible to the writer, so that Drain()
+    // never sees it written before it is pushed.
+    pushed_count_.fetch_add(1);
+    Record record(msg, level);
+    switch (policy_) {
+      case OverflowPolicy::kBLOCK:
+        ring_.Put(std::move(record));
+        break;
+      case OverflowPolicy::kDROP_NEWEST:
+        if (!ring_.TryPut(std::move(record))) {
+          logger_->dropped_count_++;
+          Complete(1);
+        }
+        break;
+      case OverflowPolicy::kDROP_OLDEST:
+        // A failed TryPut() leaves 'record' untouched
+        while (!ring_.TryPut(std::move(record))) {
+          Record oldest;
+          if (ring_.TryGet(&oldest) && !oldest.Empty()) {
+            logger_->dropped_count_++;
+            Complete(1);
+          }
+        }
+        break;
+    }
+  }
+
+  // Wait until the records pushed before the call are written or dropped.
+  void Drain()
+  {
+    const uint64_t target = pushed_count_.load();
+    std::unique_lock<std::mutex> lk(drain_mtx_);
+    drain_waiters_++;
+    drain_cv_.wait(lk, [this, target] { return completed_count_ >= target; });
+    drain_waiters_--;
+  }
+
+ private:
+  // A formatted record with its trailing newline. The record that wakes
+  // the writer to stop is empty.
+  struct Record {
+    Record() = default;
+    Record(const std::string& msg, Level level)
+        : level(level), size(msg.size() + 1)
+    {
+      if (size <= inline_text.size()) {
+        std::memcpy(inline_text.data(), msg.data(), msg.size());
+        inline_text[msg.size()] = '\n';
+      } else {
+        heap_text.reserve(size);
+        heap_text.append(msg).push_back('\n');
+      }
+    }
+
+    bool Empty() const { return size == 0; }
+    const char* Data() const
+    {
+      return heap_text.empty() ? inline_text.data() : heap_text.data();
+    }
+
+    Level level = Level::kINFO;
+    size_t size = 0;
+    std::array<char, kAsyncInlineSize> inline_text;
+    std::string heap_text;
+  };
+
+  void WriterLoop()
+  {
+    std::vector<Record> batch;
+    batch.reserve(kAsyncBatchSize);
+    while (true) {
+      batch.emplace_back(ring_.Get());
+      Record record;
+      while ((batch.size() < kAsyncBatchSize) && ring_.TryGet(&record)) {
+        batch.emplace_back(std::move(record));
+      }
+      Write(batch);
+      const size_t written =
+          std::count_if(batch.begin(), batch.end(), [](const Record& r) {
+            return !r.Empty();
+          });
+      batch.clear();
+      if (written != 0) {
+        Complete(written);
+      }
+      if (stop_ && ring_.Empty()) {
+        break;
+      }
+    }
+  }
+
+  void Complete(size_t count)
+  {
+    completed_count_.fetch_add(count);
+    if (drain_waiters_.load() != 0) {
+      std::lock_guard<std::mutex> lk(drain_mtx_);
+      drain_cv_.notify_all();
+    }
+  }
+
+#ifdef _WIN32
+  void Write(const std::vector<Record>& batch)
+  {
+    const std::lock_guard<std::mutex> lock(logger_->mutex_);
+    for (const auto& record : batch) {
+      if (record.Empty()) {
+        continue;
+      }
+      std::ostream& out = logger_->file_stream_.is_open()
+                              ? logger_->file_stream_
+                              : ((record.level == Level::kINFO) ? std::cout
+                                                                : std::cerr);
+      out.write(record.Data(), record.size);
+    }
+    logger_->file_stream_.flush();
+    std::cout.flush();
+    std::cerr.flush();
+  }
+#else
+  void Write(const std::vector<Record>& batch)
+  {
+    if (WriteLocked(batch)) {
+      ReportError(logger_->Rotate(true /* if_full */));
+    }
+  }
+
+  // Write 'batch', returns whether the log file reached its rotation size.
+  bool WriteLocked(const std::vector<Record>& batch)
+  {
+    // Held while writing so that the log file is not switched under the
+    // writes. Logging threads do not take it in asynchronous mode.
+    const std::lock_guard<std::mutex> lock(logger_->mutex_);
+    const int file_fd = FileDescriptor();
+    struct iovec iov[kAsyncBatchSize];
+    int fd = -1;
+    size_t count = 0;
+    size_t size = 0;
+    for (const auto& record : batch) {
+      if (record.Empty()) {
+        continue;
+      }
+      const int record_fd =
+          (file_fd != -1) ? file_fd
+                          : ((record.level == Level::kINFO) ? STDOUT_FILENO
+                                                            : STDERR_FILENO);
+      if ((record_fd != fd) && (count != 0)) {
+        WriteAll(fd, iov, count);
+        count = 0;
+      }
+      fd = record_fd;
+      iov[count].iov_base = const_cast<char*>(record.Data());
+      iov[count].iov_len = record.size;
+      count++;
+      size += record.size;
+    }
+    if (count != 0) {
+      WriteAll(fd, iov, count);
+    }
+    if (file_fd == -1) {
+      return false;
+    }
+    logger_->file_size_ += size;
+    return (logger_->max_file_size_ != 0) &&
+           (logger_->file_size_ >= logger_->max_file_size_);
+  }
+
+  // Descriptor of the log file, -1 if there is none. Reopened when the
+  // log file changes or is rotated. Must be called with 'mutex_' held.
+  int FileDescriptor()
+  {
+    if (logger_->file_generation_ != file_generation_) {
+      if (file_fd_ != -1) {
+        close(file_fd_);
+        file_fd_ = -1;
+      }
+      file_generation_ = logger_->file_generation_;
+      if (!logger_->filename_.empty()) {
+        file_fd_ = open(
+            logger_->filename_.c_str(),
+            O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+      }
+    }
+    return file_fd_;
+  }
+
+  static void WriteAll(int fd, struct iovec* iov, size_t count)
+  {
+    while (count != 0) {
+      const ssize_t res = writev(fd, iov, count);
+      if (res < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        // Nowhere to report the failure to
+        return;
+      }
+      size_t written = res;
+      while ((count != 0) && (written >= iov->iov_len)) {
+        written -= iov->iov_len;
+        ++iov;
+        --count;
+      }
+      if (count != 0) {
+        iov->iov_base = static_cast<char*>(iov->iov_base) + written;
+        iov->iov_len -= written;
+      }
+    }
+  }
+
+  uint64_t file_generation_ = 0;
+  int file_fd_ = -1;
+#endif
+
+  Logger* const logger_;
+  const OverflowPolicy policy_;
+  LockFreeSyncQueue<Record> ring_;
+  std::atomic<bool> stop_{false};
+  std::atomic<uint64_t> pushed_count_{0};
+  std::atomic<uint64_t> completed_count_{0};
+  std::mutex drain_mtx_;
+  std::condition_variable drain_cv_;
+  std::atomic<size_t> drain_waiters_{0};
+  // Started last, once the members it uses are initialized.
+  std::thread writer_;
+};
+
+#ifdef _WIN32
+class Logger::LogRotator {};
+#else
+//
+// Background thread of the log file rotation. Rotate() only renames the
+// log file to a staging name and reopens it; the rotator then
+// shifts the rotated files, compresses the new one, and rotates the log
+// file on SIGHUP and when the rotation interval elapses. It is woken
+// through a pipe, which the SIGHUP handler can write to.
+//
+class Logger::LogRotator {
+ public:
+  LogRotator(
+      Logger* logger, std::chrono::seconds interval, uint32_t max_files,
+      Compression compression, const int wake_fds[2])
+      : logger_(logger), interval_ms_(interval.count() * 1000),
+        max_files_(max_files), compression_(compression),
+        wake_fds_{wake_fds[0], wake_fds[1]}, rotated_at_ms_(NowMs()),
+        rotator_(&LogRotator::RotatorLoop, this)
+  {
+  }
+
+  // Retire the staged log files and stop the rotator thread. Must not be
+  // called with 'rotate_mtx_' or 'mutex_' held, which the thread takes.
+  ~LogRotator()
+  {
+    stop_ = true;
+    Wake('q');
+    rotator_.join();
+    close(wake_fds_[0]);
+    close(wake_fds_[1]);
+  }
+
+  int WakeFd() const { return wake_fds_[1]; }
+
+  // Name to rename the log file 'filename' to before it is retired.
+  std::string StagingName(const std::string& filename)
+  {
+    return filename + ".rotating." + std::to_string(++staged_count_);
+  }
+
+  // Retire 'segment', the log file 'filename' renamed by StagingName(), on
+  // the rotator thread. Restarts the rotation interval.
+  void Enqueue(const std::string& filename, const std::string& segment)
+  {
+    {
+      std::lock_guard<std::mutex> lk(segments_mtx_);
+      segments_.emplace_back(filename, segment);
+    }
+    rotated_at_ms_ = NowMs();
+    Wake('s');
+  }
+
+ private:
+  static int64_t NowMs()
+  {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  }
+
+  void Wake(char reason)
+  {
+    // A full pipe already holds pending wake ups
+    const ssize_t res = write(wake_fds_[1], &reason, 1);
+    (void)res;
+  }
+
+  void RotatorLoop()
+  {
+    while (!stop_) {
+      int timeout_ms = -1;
+      if (interval_ms_ != 0) {
+        timeout_ms = static_cast<int>(std::min<int64_t>(
+            INT_MAX, std::max<int64_t>(
+                         0, rotated_at_ms_ + interval_ms_ - NowMs())));
+      }
+      struct pollfd wake = {wake_fds_[0], POLLIN, 0};
+      bool rotate = false;
+      if (poll(&wake, 1, timeout_ms) > 0) {
+        char reasons[64];
+        const ssize_t count = read(wake_fds_[0], reasons, sizeof(reasons));
+        rotate = (count > 0) &&
+                 (std::find(reasons, reasons + count, 'r') != reasons + count);
+      }
+      if ((interval_ms_ != 0) && (NowMs() >= rotated_at_ms_ + interval_ms_)) {
+        // Also restarts the interval when the log file is empty
+        rotated_at_ms_ = NowMs();
+        rotate = true;
+      }
+      if (rotate) {
+        ReportError(logger_->Rotate(false /* if_full */));
+      }
+      RetireSegments();
+    }
+    RetireSegments();
+  }
+
+  void RetireSegments()
+  {
+    std::deque<std::pair<std::string, std::string>> segments;
+    {
+      std::lock_guard<std::mutex> lk(segments_mtx_);
+      segments.swap(segments_);
+    }
+    for (const auto& segment : segments) {
+      Retire(segment.first, segment.second);
+    }
+  }
+
+  // Shift '<filename>.N' to '<filename>.N+1', dropping the files beyond
+  // 'max_files_', then rename 'segment' to '<filename>.1' and compress it.
+  void Retire(const std::string& filename, const std::string& segment)
+  {
+    static const char* kSuffixes[] = {"", ".gz", ".zst"};
+    for (uint32_t i = max_files_; i != 0; --i) {
+      const std::string from = filename + "." + std::to_string(i);
+      const std::string to = filename + "." + std::to_string(i + 1);
+      for (const char* suffix : kSuffixes) {
+        if (i == max_files_) {
+          std::remove((from + suffix).c_str());
+        } else {
+          std::rename((from + suffix).c_str(), (to + suffix).c_str());
+        }
+      }
+    }
+    const std::string rotated = filename + ".1";
+    if (std::rename(segment.c_str(), rotated.c_str()) != 0) {
+      return;
+    }
+    const std::string compressed = rotated + CompressionSuffix(compression_);
+    bool success = false;
+    switch (compression_) {
+#ifdef TRITON_ENABLE_LOG_GZIP
+      case Compression::kGZIP:
+        success = GzipFile(rotated, compressed);
+        break;
+#endif
+#ifdef TRITON_ENABLE_LOG_ZSTD
+      case Compression::kZSTD:
+        success = ZstdFile(rotated, compressed);
+        break;
+#endif
+      default:
+        break;
+    }
+    // Left uncompressed on failure
+    if (success) {
+      std::remove(rotated.c_str());
+    }
+  }
+
+  Logger* const logger_;
+  const int64_t interval_ms_;
+  const uint32_t max_files_;
+  const Compression compression_;
+  const int wake_fds_[2];
+  std::atomic<int64_t> rotated_at_ms_;
+  std::atomic<bool> stop_{false};
+  // Guarded by the logger 'mutex_'
+  uint64_t staged_count_ = 0;
+  std::mutex segments_mtx_;
+  std::deque<std::pair<std::string, std::string>> segments_;
+  // Started last, once the members it uses are initialized.
+  std::thread rotator_;
+};
+#endif  // _WIN32
+
 Logger gLogger_;
 
 Logger::Logger()
@@ -51,100 +963,666 @@ Logger::Logger()
   escape_log_messages_ = (value && std::strcmp(value, "0") == 0) ? false : true;
 }
 
-void
-Logger::Log(const std::string& msg, const Level level)
+// Stops the asynchronous writer, if any, after it writes the pending records.
+Logger::~Logger()
+{
+#ifndef _WIN32
+  // Not to let SIGHUP write to the pipe of the rotator once it is closed
+  SetRotateOnSighup(false);
+#endif  // !_WIN32
+}
+
+uint32_t
+Logger::VerboseLevel(const char* file)
+{
+  if (!has_vmodules_.load(std::memory_order_acquire)) {
+    return vlevel_;
+  }
+  // The module is the file name without directory and extension
+  const char* module = LogBasename(file);
+  const char* extension = std::strchr(module, '.');
+  const size_t module_size = (extension != nullptr)
+                                 ? static_cast<size_t>(extension - module)
+                                 : std::strlen(module);
+  std::lock_guard<std::mutex> lk(vmodule_mtx_);
+  for (const auto& vmodule : vmodules_) {
+    if (GlobMatch(vmodule.first.c_str(), module, module_size)) {
+      return vmodule.second;
+    }
+  }
+  return vlevel_;
+}
+
+std::string
+Logger::VerboseModules()
+{
+  std::lock_guard<std::mutex> lk(vmodule_mtx_);
+  return vmodule_spec_;
+}
+
+const std::string
+Logger::SetVerboseModules(const std::string& modules)
+{
+  std::vector<std::pair<std::string, uint32_t>> vmodules;
+  std::stringstream entries(modules);
+  for (std::string entry; std::getline(entries, entry, ',');) {
+    const size_t begin = entry.find_first_not_of(" \t");
+    if (begin == std::string::npos) {
+      continue;
+    }
+    entry = entry.substr(begin, entry.find_last_not_of(" \t") + 1 - begin);
+    const size_t equal = entry.find('=');
+    const std::string level =
+        (equal != std::string::npos) ? entry.substr(equal + 1) : "";
+    if ((equal == 0) || level.empty() ||
+        (level.find_first_not_of("0123456789") != std::string::npos) ||
+        (level.size() > 9)) {
+      std::stringstream error;
+      error << __FILE__ << " " << __LINE__
+            << ": Invalid verbose module setting '" << entry
+            << "', expected 'pattern=level'" << std::endl;
+      return error.str();
+    }
+    vmodules.emplace_back(entry.substr(0, equal), std::stoul(level));
+  }
+  {
+    std::lock_guard<std::mutex> lk(vmodule_mtx_);
+    vmodule_spec_ = modules;
+    vmodules_ = std::move(vmodules);
+    has_vmodules_ = !vmodules_.empty();
+  }
+  verbose_generation_++;
+  return std::string();
+}
+
+const std::string
+Logger::SetLogFile(const std::string& filename)
 {
+  if (IsAsync()) {
+    // Write the pending records to the previous file
+    Flush();
+  }
+  const std::lock_guard<std::mutex> rotate_lock(rotate_mtx_);
   const std::lock_guard<std::mutex> lock(mutex_);
-  if (file_stream_.is_open()) {
-    file_stream_ << msg << std::endl;
-  } else if (level == Level::kINFO) {
-    std::cout << msg << std::endl;
-  } else {  // kWARNING or kERROR
-    std::cerr << msg << std::endl;
+  file_stream_.close();
+  file_generation_++;
+  file_size_ = 0;
+  std::string revert_name(filename_);
+  filename_ = filename;
+  if (!filename_.empty()) {
+    file_stream_.open(filename_, std::ios::app);
+    if (file_stream_.fail()) {
+      std::stringstream error;
+      error << __FILE__ << " " << __LINE__
+            << ": Failed to open log file: " << std::strerror(errno)
+            << std::endl;
+      filename_ = revert_name;
+      file_stream_.open(filename_, std::ios::app);
+      return error.str();
+    }
+    // Appended to, count the existing content towards the rotation size
+    const std::streamoff size = file_stream_.seekp(0, std::ios::end).tellp();
+    file_size_ = (size > 0) ? size : 0;
   }
+  // will return an empty string
+  return std::string();
 }
 
-void
-Logger::Flush()
+const std::string
+Logger::SetLogRotation(
+    uint64_t max_size, std::chrono::seconds interval, uint32_t max_files,
+    Compression compression)
 {
-  std::cerr << std::flush;
+  std::stringstream error;
+#ifdef _WIN32
+  error << __FILE__ << " " << __LINE__
+        << ": Log file rotation is not supported on Windows" << std::endl;
+  return error.str();
+#else
+  const char* unavailable = nullptr;
+#ifndef TRITON_ENABLE_LOG_GZIP
+  if (compression == Compression::kGZIP) {
+    unavailable = "gzip";
+  }
+#endif
+#ifndef TRITON_ENABLE_LOG_ZSTD
+  if (compression == Compression::kZSTD) {
+    unavailable = "zstd";
+  }
+#endif
+  if (unavailable != nullptr) {
+    error << __FILE__ << " " << __LINE__ << ": " << unavailable
+          << " compression of rotated log files is not available in this build"
+          << std::endl;
+    return error.str();
+  }
+  int wake_fds[2];
+  if ((max_files != 0) && (pipe2(wake_fds, O_CLOEXEC | O_NONBLOCK) != 0)) {
+    error << __FILE__ << " " << __LINE__
+          << ": Failed to start log file rotation: " << std::strerror(errno)
+          << std::endl;
+    return error.str();
+  }
+  // Stop the previous rotator outside of 'rotate_mtx_' and 'mutex_', which
+  // its thread takes
+  std::unique_ptr<LogRotator> previous;
+  {
+    const std::lock_guard<std::mutex> rotate_lock(rotate_mtx_);
+    const std::lock_guard<std::mutex> lock(mutex_);
+    previous = std::move(rotator_);
+    max_file_size_ = 0;
+    if (sighup_installed) {
+      sighup_fd = -1;
+    }
+  }
+  previous.reset();
+  if (max_files == 0) {
+    return std::string();
+  }
+  const std::lock_guard<std::mutex> rotate_lock(rotate_mtx_);
+  const std::lock_guard<std::mutex> lock(mutex_);
+  rotator_.reset(
+      new LogRotator(this, interval, max_files, compression, wake_fds));
+  max_file_size_ = max_size;
+  if (sighup_installed) {
+    sighup_fd = rotator_->WakeFd();
+  }
+  return std::string();
+#endif  // _WIN32
 }
 
+const std::string
+Logger::RotateLogFile()
+{
+  if (IsAsync()) {
+    // Write the pending records to the rotated file
+    Flush();
+  }
+  {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    if ((rotator_ == nullptr) || filename_.empty()) {
+      std::stringstream error;
+      error << __FILE__ << " " << __LINE__
+            << ": Log file rotation requires a log file and SetLogRotation()"
+            << std::endl;
+      return error.str();
+    }
+  }
+  return Rotate(false /* if_full */);
+}
+
+const std::string
+Logger::SetRotateOnSighup(bool enable)
+{
+  std::stringstream error;
 #ifdef _WIN32
+  error << __FILE__ << " " << __LINE__
+        << ": Log file rotation is not supported on Windows" << std::endl;
+  return error.str();
+#else
+  const std::lock_guard<std::mutex> lock(mutex_);
+  if (enable == sighup_installed) {
+    return std::string();
+  }
+  if (!enable) {
+    sighup_fd = -1;
+    sigaction(SIGHUP, &previous_sighup_action, nullptr);
+    sighup_installed = false;
+    return std::string();
+  }
+  struct sigaction action;
+  std::memset(&action, 0, sizeof(action));
+  action.sa_handler = HandleSighup;
+  action.sa_flags = SA_RESTART;
+  sigemptyset(&action.sa_mask);
+  if (sigaction(SIGHUP, &action, &previous_sighup_action) != 0) {
+    error << __FILE__ << " " << __LINE__
+          << ": Failed to handle SIGHUP: " << std::strerror(errno)
+          << std::endl;
+    return error.str();
+  }
+  sighup_installed = true;
+  sighup_fd = (rotator_ != nullptr) ? rotator_->WakeFd() : -1;
+  return std::string();
+#endif  // _WIN32
+}
 
-void
-LogMessage::LogTimestamp(std::stringstream& stream)
-{
-  switch (gLogger_.LogFormat()) {
-    case Logger::Format::kDEFAULT: {
-      stream << std::setfill('0') << std::setw(2) << timestamp_.wMonth
-             << std::setw(2) << timestamp_.wDay << ' ' << std::setw(2)
-             << timestamp_.wHour << ':' << std::setw(2) << timestamp_.wMinute
-             << ':' << std::setw(2) << timestamp_.wSecond << '.' << std::setw(6)
-             << timestamp_.wMilliseconds * 1000;
-      break;
+#ifdef _WIN32
+const std::string
+Logger::Rotate(bool if_full)
+{
+  return std::string();
+}
+#else
+const std::string
+Logger::Rotate(bool if_full)
+{
+  // Logging threads that reach the rotation size leave it to the one
+  // already rotating instead of waiting
+  std::unique_lock<std::mutex> rotate_lock(rotate_mtx_, std::defer_lock);
+  if (!if_full) {
+    rotate_lock.lock();
+  } else if (!rotate_lock.try_lock()) {
+    return std::string();
+  }
+  // 'filename_' and 'rotator_' only change with 'rotate_mtx_' held
+  std::string segment;
+  {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    if ((rotator_ == nullptr) || filename_.empty() || (file_size_ == 0) ||
+        (if_full &&
+         ((max_file_size_ == 0) || (file_size_ < max_file_size_)))) {
+      return std::string();
     }
-    case Logger::Format::kISO8601: {
-      stream << timestamp_.wYear << '-' << std::setfill('0') << std::setw(2)
-             << timestamp_.wMonth << '-' << std::setw(2) << timestamp_.wDay
-             << 'T' << std::setw(2) << timestamp_.wHour << ':' << std::setw(2)
-             << timestamp_.wMinute << ':' << std::setw(2) << timestamp_.wSecond
-             << "Z";
-      break;
+    segment = rotator_->StagingName(filename_);
+  }
+
+  // The records logged until the switch below are written to the renamed
+  // file
+  std::stringstream error;
+  std::ofstream file_stream;
+  if (std::rename(filename_.c_str(), segment.c_str()) != 0) {
+    error << __FILE__ << " " << __LINE__
+          << ": Failed to rotate log file: " << std::strerror(errno)
+          << std::endl;
+  } else {
+    file_stream.open(filename_, std::ios::app);
+    if (file_stream.fail()) {
+      error << __FILE__ << " " << __LINE__
+            << ": Failed to reopen rotated log file: " << std::strerror(errno)
+            << std::endl;
+      // Keep writing to the current log file, under its name
+      std::rename(segment.c_str(), filename_.c_str());
     }
   }
+  if (!error.str().empty()) {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    // Not to retry on every record
+    file_size_ = 0;
+    return error.str();
+  }
+
+  {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    file_stream_.swap(file_stream);
+    file_generation_++;
+    file_size_ = 0;
+  }
+  // Written to by no one since the switch
+  file_stream.close();
+  rotator_->Enqueue(filename_, segment);
+  return std::string();
 }
+#endif  // _WIN32
+
+const std::string
+Logger::SetAsync(bool enable, size_t capacity, OverflowPolicy policy)
+{
+  if (!enable) {
+    async_writer_.reset();
+    return std::string();
+  }
+  if ((async_writer_ != nullptr) || (capacity == 0)) {
+    std::stringstream error;
+    error << __FILE__ << " " << __LINE__ << ": "
+          << ((async_writer_ != nullptr)
+                  ? "Asynchronous logging is already enabled"
+                  : "Asynchronous logging capacity must be positive")
+          << std::endl;
+    return error.str();
+  }
+  {
+    // Write the records logged so far before the asynchronous ones
+    const std::lock_guard<std::mutex> lock(mutex_);
+    file_stream_.flush();
+    std::cout.flush();
+    std::cerr.flush();
+  }
+  async_writer_.reset(new AsyncWriter(this, capacity, policy));
+  return std::string();
+}
+
+const std::string
+Logger::SetBinaryLog(const std::string& directory, size_t ring_size)
+{
+  std::stringstream error;
+#ifdef _WIN32
+  error << __FILE__ << " " << __LINE__
+        << ": Binary logging is not supported on Windows" << std::endl;
+  return error.str();
 #else
-void
-LogMessage::LogTimestamp(std::stringstream& stream)
+  int fd = -1;
+  if (!directory.empty()) {
+    if ((ring_size < kBinaryMinRingSize) || (ring_size > kBinaryMaxRingSize)) {
+      error << __FILE__ << " " << __LINE__
+            << ": Binary log ring size must be between " << kBinaryMinRingSize
+            << " and " << kBinaryMaxRingSize << " bytes" << std::endl;
+      return error.str();
+    }
+    const std::string path =
+        directory + "/triton." + std::to_string(getpid()) + ".sites";
+    fd = open(
+        path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC,
+        0644);
+    if (fd == -1) {
+      error << __FILE__ << " " << __LINE__
+            << ": Failed to create binary log sites file: "
+            << std::strerror(errno) << std::endl;
+      return error.str();
+    }
+  }
+  {
+    // The call sites registered so far are written to the new file, the
+    // next ones by LogFormatSite::Register()
+    LogFormatSites& sites = FormatSites();
+    const std::lock_guard<std::mutex> lock(sites.mutex);
+    if (sites.fd != -1) {
+      close(sites.fd);
+    }
+    sites.fd = fd;
+    if (fd != -1) {
+      std::string content(kLogBinarySitesMagic, sizeof(kLogBinarySitesMagic));
+      const uint32_t prefix[2] = {
+          kLogBinaryVersion, static_cast<uint32_t>(getpid())};
+      content.append(reinterpret_cast<const char*>(prefix), sizeof(prefix));
+      for (size_t i = 0; i < sites.entries.size(); ++i) {
+        AppendSiteEntry(&content, i + 1, sites.entries[i]);
+      }
+      if (!WriteAll(fd, content)) {
+        error << __FILE__ << " " << __LINE__
+              << ": Failed to write binary log sites file: "
+              << std::strerror(errno) << std::endl;
+        close(fd);
+        sites.fd = -1;
+        return error.str();
+      }
+    }
+  }
+  const std::lock_guard<std::mutex> lock(mutex_);
+  binary_directory_ = directory;
+  binary_ring_size_ = ring_size & ~size_t(7);
+  binary_session_ = directory.empty() ? 0 : ++binary_sessions_;
+  return std::string();
+#endif  // _WIN32
+}
+
+bool
+Logger::WriteBinary(
+    uint32_t site, const LogBinaryValue* values, size_t count,
+    uint64_t timestamp_ns)
 {
-  struct tm tm_time;
-  gmtime_r(((time_t*)&(timestamp_.tv_sec)), &tm_time);
-
-  switch (gLogger_.LogFormat()) {
-    case Logger::Format::kDEFAULT: {
-      stream << std::setfill('0') << std::setw(2) << (tm_time.tm_mon + 1)
-             << std::setw(2) << tm_time.tm_mday << ' ' << std::setw(2)
-             << tm_time.tm_hour << ':' << std::setw(2) << tm_time.tm_min << ':'
-             << std::setw(2) << tm_time.tm_sec << '.' << std::setw(6)
-             << timestamp_.tv_usec;
-      break;
+#ifdef _WIN32
+  return false;
+#else
+  LogBuffers& buffers = ThreadLogBuffers();
+  LogBinaryRing& ring = buffers.binary_ring;
+  if (ring.Session() != binary_session_.load(std::memory_order_acquire)) {
+    std::string directory;
+    size_t ring_size;
+    uint32_t session;
+    {
+      const std::lock_guard<std::mutex> lock(mutex_);
+      directory = binary_directory_;
+      ring_size = binary_ring_size_;
+      session = binary_session_;
     }
-    case Logger::Format::kISO8601: {
-      stream << (tm_time.tm_year + 1900) << '-' << std::setfill('0')
-             << std::setw(2) << (tm_time.tm_mon + 1) << '-' << std::setw(2)
-             << tm_time.tm_mday << 'T' << std::setw(2) << tm_time.tm_hour << ':'
-             << std::setw(2) << tm_time.tm_min << ':' << std::setw(2)
-             << tm_time.tm_sec << "Z";
-      break;
+    ring.Map(directory, ring_size, session, ThreadId(buffers));
+  }
+  if (timestamp_ns == 0) {
+    timestamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::system_clock::now().time_since_epoch())
+                       .count();
+  }
+  return ring.Write(site, timestamp_ns, values, count);
+#endif  // _WIN32
+}
+
+void
+Logger::Log(const std::string& msg, const Level level)
+{
+  if (async_writer_ != nullptr) {
+    async_writer_->Push(msg, level);
+    return;
+  }
+  bool rotate = false;
+  {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    if (file_stream_.is_open()) {
+      file_stream_ << msg << std::endl;
+      file_size_ += msg.size() + 1;
+      rotate = (max_file_size_ != 0) && (file_size_ >= max_file_size_);
+    } else if (level == Level::kINFO) {
+      std::cout << msg << std::endl;
+    } else {  // kWARNING or kERROR
+      std::cerr << msg << std::endl;
     }
   }
+  if (rotate) {
+    ReportError(Rotate(true /* if_full */));
+  }
+}
+
+void
+Logger::Flush()
+{
+  if (async_writer_ != nullptr) {
+    async_writer_->Drain();
+  }
+  std::cerr << std::flush;
+}
+
+std::stringstream*
+LogMessage::AcquireStream(std::unique_ptr<std::stringstream>* owned)
+{
+  LogBuffers& buffers = ThreadLogBuffers();
+  if (buffers.stream_in_use) {
+    // A message is logged while the message of this thread is built
+    owned->reset(new std::stringstream());
+    return owned->get();
+  }
+  buffers.stream_in_use = true;
+  // Clear the content but keep the capacity, which assigning a temporary
+  // string would not
+  static const std::string kEmpty;
+  std::stringstream& stream = buffers.stream;
+  stream.str(kEmpty);
+  stream.clear();
+  stream.flags(std::ios_base::dec | std::ios_base::skipws);
+  stream.precision(6);
+  stream.width(0);
+  stream.fill(' ');
+  return &stream;
+}
+
+void
+LogMessage::ReleaseStream()
+{
+  if (owned_message_ == nullptr) {
+    ThreadLogBuffers().stream_in_use = false;
+  }
 }
 
+#ifdef _WIN32
+uint64_t
+LogMessage::TimestampMicros() const
+{
+  // FILETIME counts 100ns intervals since 1601-01-01
+  constexpr uint64_t kEpochOffset = 116444736000000000ULL;
+  FILETIME file_time;
+  SystemTimeToFileTime(&timestamp_, &file_time);
+  const uint64_t intervals =
+      (static_cast<uint64_t>(file_time.dwHighDateTime) << 32) |
+      file_time.dwLowDateTime;
+  return (intervals - kEpochOffset) / 10;
+}
+#else
+uint64_t
+LogMessage::TimestampMicros() const
+{
+  return static_cast<uint64_t>(timestamp_.tv_sec) * kMicrosecondsPerSecond +
+         static_cast<uint64_t>(timestamp_.tv_usec);
+}
 #endif
 
+namespace {
+
+// Append the timestamp 'timestamp_us' in 'format', which is not JSON.
 void
-LogMessage::LogPreamble(std::stringstream& stream)
+AppendTimestamp(
+    std::string* record, Logger::Format format, uint64_t timestamp_us)
 {
-  switch (gLogger_.LogFormat()) {
-    case Logger::Format::kDEFAULT: {
-      stream << Logger::LEVEL_NAMES[static_cast<uint8_t>(level_)];
-      LogTimestamp(stream);
-      stream << ' ' << pid_ << ' ' << path_ << ':' << line_ << "] ";
+  LogBuffers& buffers = ThreadLogBuffers();
+  const time_t second =
+      static_cast<time_t>(timestamp_us / kMicrosecondsPerSecond);
+  if (buffers.tm_second != second) {
+#ifdef _WIN32
+    gmtime_s(&buffers.tm_time, &second);
+#else
+    gmtime_r(&second, &buffers.tm_time);
+#endif
+    buffers.tm_second = second;
+  }
+  const struct tm& tm_time = buffers.tm_time;
+  if (format == Logger::Format::kISO8601) {
+    AppendDecimal(record, tm_time.tm_year + 1900);
+    record->push_back('-');
+    AppendDecimal(record, tm_time.tm_mon + 1, 2);
+    record->push_back('-');
+    AppendDecimal(record, tm_time.tm_mday, 2);
+    record->push_back('T');
+    AppendDecimal(record, tm_time.tm_hour, 2);
+    record->push_back(':');
+    AppendDecimal(record, tm_time.tm_min, 2);
+    record->push_back(':');
+    AppendDecimal(record, tm_time.tm_sec, 2);
+    record->push_back('Z');
+    return;
+  }
+  AppendDecimal(record, tm_time.tm_mon + 1, 2);
+  AppendDecimal(record, tm_time.tm_mday, 2);
+  record->push_back(' ');
+  AppendDecimal(record, tm_time.tm_hour, 2);
+  record->push_back(':');
+  AppendDecimal(record, tm_time.tm_min, 2);
+  record->push_back(':');
+  AppendDecimal(record, tm_time.tm_sec, 2);
+  record->push_back('.');
+  AppendDecimal(record, timestamp_us % kMicrosecondsPerSecond, 6);
+}
 
-      break;
-    }
-    case Logger::Format::kISO8601: {
-      LogTimestamp(stream);
-      stream << " " << Logger::LEVEL_NAMES[static_cast<uint8_t>(level_)] << ' '
-             << pid_ << ' ' << path_ << ':' << line_ << "] ";
-      break;
-    }
+void
+AppendLine(std::string* record, int line)
+{
+  if (line < 0) {
+    record->push_back('-');
+  }
+  AppendDecimal(record, std::abs(static_cast<int64_t>(line)));
+}
+
+void
+AppendJsonRecord(std::string* record, const LogRecordFields& fields)
+{
+  record->append("{\"level\":\"");
+  record->append(kJsonLevelNames[static_cast<uint8_t>(fields.level)]);
+  record->append("\",\"timestamp_us\":");
+  AppendDecimal(record, fields.timestamp_us);
+  record->append(",\"pid\":");
+  AppendDecimal(record, fields.pid);
+  record->append(",\"tid\":");
+  AppendDecimal(record, fields.tid);
+  record->append(",\"file\":");
+  AppendEscaped(record, fields.file);
+  record->append(",\"line\":");
+  AppendLine(record, fields.line);
+  record->append(
+      fields.verbose ? ",\"verbose\":true" : ",\"verbose\":false");
+  record->append(",\"heading\":");
+  if (fields.heading != nullptr) {
+    AppendEscaped(record, fields.heading);
+  } else {
+    record->append("null");
   }
+  // The message is always escaped, a record must be a valid JSON line
+  record->append(",\"message\":");
+  AppendEscaped(record, fields.message);
+  record->push_back('}');
 }
 
+}  // namespace
+
+void
+LogFormatRecord(
+    std::string* record, Logger::Format format, const LogRecordFields& fields)
+{
+  if (format == Logger::Format::kJSON) {
+    AppendJsonRecord(record, fields);
+    return;
+  }
+  const char* level_name =
+      Logger::LEVEL_NAMES[static_cast<uint8_t>(fields.level)];
+  if (format == Logger::Format::kISO8601) {
+    AppendTimestamp(record, format, fields.timestamp_us);
+    record->push_back(' ');
+    record->append(level_name);
+  } else {
+    record->append(level_name);
+    AppendTimestamp(record, format, fields.timestamp_us);
+  }
+  record->push_back(' ');
+  AppendDecimal(record, fields.pid);
+  record->push_back(' ');
+  record->append(fields.file);
+  record->push_back(':');
+  AppendLine(record, fields.line);
+  record->append("] ");
+  if (fields.heading != nullptr) {
+    if (fields.escape_heading) {
+      AppendEscaped(record, fields.heading);
+    } else {
+      record->append(fields.heading);
+    }
+    record->push_back('\n');
+  }
+  if (fields.escape) {
+    AppendEscaped(record, fields.message);
+  } else {
+    record->append(fields.message);
+  }
+}
 
 LogMessage::~LogMessage()
+{
+  const bool has_callback = static_cast<bool>(gLogger_.LogCallback());
+  // Not the per-thread buffers with a callback, which may log with them
+  std::string callback_message;
+  std::string& message =
+      has_callback ? callback_message : ThreadLogBuffers().message;
+  ReadStream(*message_, &message);
+  ReleaseStream();
+  if (site_ != nullptr) {
+    uint64_t repeats = 0;
+    const bool repeated = gLogger_.SuppressRepeats() &&
+                          site_->SuppressRepeat(heading_, message, &repeats);
+    if (repeats != 0) {
+      Write(
+          nullptr,
+          "last message repeated " + std::to_string(repeats) + " times");
+    }
+    if (repeated) {
+      return;
+    }
+    const uint64_t suppressed = site_->TakeSuppressed();
+    if (suppressed != 0) {
+      message.append(" [")
+          .append(std::to_string(suppressed))
+          .append(" similar messages suppressed]");
+    }
+  }
+  Write(heading_, message);
+}
+
+void
+LogMessage::Write(const char* heading, const std::string& message)
 {
   // If a structured callback is registered, send the raw Triton log record to
   // it and skip the default sink. This allows the host to route Triton logs
@@ -155,16 +1633,13 @@ LogMessage::~LogMessage()
   // throw.
   const Logger::LogCallbackFn& callback = gLogger_.LogCallback();
   if (callback) {
-    uint64_t timestamp_us =
-        static_cast<uint64_t>(timestamp_.tv_sec) * kMicrosecondsPerSecond +
-        static_cast<uint64_t>(timestamp_.tv_usec);
-    const std::string message = message_.str();
+    const uint64_t timestamp_us = TimestampMicros();
     const std::string raw_message =
-        (heading_ != nullptr) ? (std::string(heading_) + "\n" + message)
-                              : message;
+        (heading != nullptr) ? (std::string(heading) + "\n" + message)
+                             : message;
     try {
       callback(
-          level_, is_verbose_, path_.c_str(), line_, timestamp_us,
+          level_, is_verbose_, path_, line_, timestamp_us,
           raw_message.c_str());
     }
     catch (...) {
@@ -173,20 +1648,82 @@ LogMessage::~LogMessage()
     return;
   }
 
-  // Default sink: format the log record and write it to the configured output.
-  std::stringstream log_record;
-  LogPreamble(log_record);
-  std::string escaped_message =
-      escape_log_messages_ ? TritonJson::SerializeString(message_.str())
-                           : message_.str();
-  if (heading_ != nullptr) {
-    std::string escaped_heading = gLogger_.EscapeLogMessages()
-                                      ? TritonJson::SerializeString(heading_)
-                                      : heading_;
-    log_record << escaped_heading << '\n';
-  }
-  log_record << escaped_message;
-  gLogger_.Log(log_record.str(), level_);
+  // Binary log: write the raw record, formatted by triton-log-decode
+  if (gLogger_.IsBinary()) {
+    const LogBinaryValue values[] = {
+        LogBinaryValue(static_cast<uint32_t>(level_)),
+        LogBinaryValue(is_verbose_),
+        LogBinaryValue(gLogger_.EscapeLogMessages()),
+        LogBinaryValue(escape_log_messages_),
+        LogBinaryValue(line_),
+        LogBinaryValue(path_),
+        LogBinaryValue((heading != nullptr) ? heading : ""),
+        LogBinaryValue(message)};
+    if (gLogger_.WriteBinary(
+            kLogBinaryMessageSite, values, sizeof(values) / sizeof(values[0]),
+            TimestampMicros() * 1000)) {
+      return;
+    }
+  }
+
+  // Default sink: format the log record into the per-thread buffer and write
+  // it to the configured output.
+  LogBuffers& buffers = ThreadLogBuffers();
+  std::string& record = buffers.record;
+  record.clear();
+  LogFormatRecord(
+      &record, gLogger_.LogFormat(),
+      {level_, is_verbose_, TimestampMicros(), pid_, ThreadId(buffers), path_,
+       line_, heading, message, gLogger_.EscapeLogMessages(),
+       escape_log_messages_});
+  gLogger_.Log(record, level_);
+}
+
+uint32_t
+LogFormatSite::Register(const char* format)
+{
+  LogFormatSites& sites = FormatSites();
+  const std::lock_guard<std::mutex> lock(sites.mutex);
+  uint32_t id = id_.load(std::memory_order_relaxed);
+  if (id == 0) {
+    sites.entries.push_back({file_, line_, format});
+    id = static_cast<uint32_t>(sites.entries.size());
+#ifndef _WIN32
+    if (sites.fd != -1) {
+      std::string entry;
+      AppendSiteEntry(&entry, id, sites.entries.back());
+      WriteAll(sites.fd, entry);
+    }
+#endif  // !_WIN32
+    id_.store(id, std::memory_order_release);
+  }
+  return id;
+}
+
+bool
+LogSite::SuppressRepeat(
+    const char* heading, const std::string& message, uint64_t* repeats)
+{
+  uint64_t hash = std::hash<std::string_view>()(message);
+  if (heading != nullptr) {
+    hash ^= std::hash<std::string_view>()(heading) + 0x9e3779b97f4a7c15ULL +
+            (hash << 6) + (hash >> 2);
+  }
+  *repeats = 0;
+  if (last_hash_.exchange(hash, std::memory_order_relaxed) != hash) {
+    *repeats = repeats_.exchange(0, std::memory_order_relaxed);
+    return false;
+  }
+  const int64_t now = NowNs();
+  if (repeats_.fetch_add(1, std::memory_order_relaxed) == 0) {
+    repeats_since_ns_.store(now, std::memory_order_relaxed);
+  } else if (
+      now - repeats_since_ns_.load(std::memory_order_relaxed) >=
+      kRepeatSummaryNs) {
+    // Summarize long runs of repeats without waiting for their end
+    *repeats = repeats_.exchange(0, std::memory_order_relaxed);
+  }
+  return true;
 }
 
 }}  // namespace triton::common
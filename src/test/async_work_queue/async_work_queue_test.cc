@@ -0,0 +1,163 @@
+// Copyright 2026, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "triton/common/async_work_queue.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace tc = triton::common;
+
+namespace {
+
+// Exposes the reset of the queues, never instantiated.
+struct AsyncWorkQueueResetter : public tc::AsyncWorkQueue {
+  using tc::AsyncWorkQueue::Reset;
+};
+
+class AsyncWorkQueueTest : public ::testing::Test {
+ protected:
+  void TearDown() override { AsyncWorkQueueResetter::Reset(); }
+};
+
+// Validate that the static functions operate on the default queue.
+TEST_F(AsyncWorkQueueTest, StaticFunctionsUseDefaultQueue)
+{
+  EXPECT_FALSE(tc::AsyncWorkQueue::AddTask([]() {}).IsOk());
+  EXPECT_FALSE(tc::AsyncWorkQueue::Initialize(0).IsOk());
+  ASSERT_TRUE(tc::AsyncWorkQueue::Initialize(2).IsOk());
+  EXPECT_FALSE(tc::AsyncWorkQueue::Initialize(2).IsOk());
+  EXPECT_EQ(tc::AsyncWorkQueue::WorkerCount(), 2u);
+  EXPECT_EQ(
+      tc::AsyncWorkQueue::Get(tc::AsyncWorkQueue::kDefaultQueue)
+          ->WorkerCount(),
+      2u);
+
+  std::promise<void> done;
+  ASSERT_TRUE(
+      tc::AsyncWorkQueue::AddTask([&done]() { done.set_value(); }).IsOk());
+  done.get_future().wait();
+}
+
+// Validate that named queues are registered once and sized independently.
+TEST_F(AsyncWorkQueueTest, NamedQueuesAreIndependent)
+{
+  tc::WorkQueue* io = tc::AsyncWorkQueue::Get("io");
+  tc::WorkQueue* completion = tc::AsyncWorkQueue::Get("completion");
+  ASSERT_NE(io, completion);
+  EXPECT_EQ(tc::AsyncWorkQueue::Get("io"), io);
+  EXPECT_EQ(io->Name(), "io");
+
+  ASSERT_TRUE(io->Initialize(2).IsOk());
+  ASSERT_TRUE(completion->Initialize(1).IsOk());
+  EXPECT_EQ(io->WorkerCount(), 2u);
+  EXPECT_EQ(completion->WorkerCount(), 1u);
+  EXPECT_EQ(tc::AsyncWorkQueue::WorkerCount(), 0u);
+
+  // A blocked queue does not hold back the others
+  std::promise<void> release;
+  std::shared_future<void> released = release.get_future().share();
+  ASSERT_TRUE(io->AddTask([released]() { released.wait(); }).IsOk());
+  ASSERT_TRUE(io->AddTask([released]() { released.wait(); }).IsOk());
+  std::promise<void> completed;
+  ASSERT_TRUE(
+      completion->AddTask([&completed]() { completed.set_value(); }).IsOk());
+  completed.get_future().wait();
+  release.set_value();
+
+  const std::vector<std::string> names = tc::AsyncWorkQueue::QueueNames();
+  const std::vector<std::string> expected{"completion", "default", "io"};
+  EXPECT_EQ(names, expected);
+}
+
+// Validate that serial tasks of a key run in order.
+TEST_F(AsyncWorkQueueTest, SerialTasksRunInOrder)
+{
+  tc::WorkQueue* queue = tc::AsyncWorkQueue::Get("serial");
+  EXPECT_FALSE(queue->AddSerialTask(1, []() {}).IsOk());
+  ASSERT_TRUE(queue->Initialize(4).IsOk());
+
+  constexpr int kTasks = 100;
+  std::vector<int> order;
+  std::promise<void> done;
+  for (int i = 0; i < kTasks; ++i) {
+    ASSERT_TRUE(queue
+                    ->AddSerialTask(
+                        7,
+                        [&order, &done, i]() {
+                          order.push_back(i);
+                          if (i == kTasks - 1) {
+                            done.set_value();
+                          }
+                        })
+                    .IsOk());
+  }
+  done.get_future().wait();
+  ASSERT_EQ(order.size(), size_t(kTasks));
+  for (int i = 0; i < kTasks; ++i) {
+    EXPECT_EQ(order[i], i);
+  }
+}
+
+// Validate that delayed tasks run on the queue and can be cancelled.
+TEST_F(AsyncWorkQueueTest, DelayedTasks)
+{
+  tc::TimerWheel::TimerId id = 0;
+  EXPECT_FALSE(tc::AsyncWorkQueue::AddTaskAfter(
+                   std::chrono::microseconds(0), []() {}, &id)
+                   .IsOk());
+  ASSERT_TRUE(tc::AsyncWorkQueue::Initialize(1).IsOk());
+  // Before any delayed task
+  EXPECT_EQ(
+      tc::AsyncWorkQueue::CancelTask(1).ErrorCode(),
+      tc::Error::Code::NOT_FOUND);
+
+  std::atomic<int> cancelled_ran{0};
+  ASSERT_TRUE(tc::AsyncWorkQueue::AddTaskAfter(
+                  std::chrono::milliseconds(5),
+                  [&cancelled_ran]() { cancelled_ran++; }, &id)
+                  .IsOk());
+  EXPECT_NE(id, 0u);
+  EXPECT_TRUE(tc::AsyncWorkQueue::CancelTask(id).IsOk());
+  EXPECT_FALSE(tc::AsyncWorkQueue::CancelTask(id).IsOk());
+
+  std::promise<void> done;
+  ASSERT_TRUE(tc::AsyncWorkQueue::AddTaskAt(
+                  std::chrono::steady_clock::now() +
+                      std::chrono::milliseconds(10),
+                  [&done]() { done.set_value(); })
+                  .IsOk());
+  done.get_future().wait();
+  EXPECT_EQ(cancelled_ran, 0);
+}
+
+}  // namespace
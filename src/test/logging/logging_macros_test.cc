@@ -0,0 +1,119 @@
+// Copyright 2026, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// The logging macros of this translation unit are enabled, and verbose
+// levels above 2 are compiled out of it.
+#ifndef TRITON_ENABLE_LOGGING
+#define TRITON_ENABLE_LOGGING 1
+#endif
+#undef TRITON_LOG_MAX_VERBOSE
+#define TRITON_LOG_MAX_VERBOSE 2
+
+#include "triton/common/logging.h"
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace tc = triton::common;
+
+namespace {
+
+// Counts how many times it is formatted.
+struct CountedArg {
+  int* formatted;
+};
+
+std::ostream&
+operator<<(std::ostream& out, const CountedArg& arg)
+{
+  ++*arg.formatted;
+  return out << "counted";
+}
+
+// The logger is a process-global singleton, restore its verbose level and
+// callback after each test.
+class LogMacrosTest : public ::testing::Test {
+ protected:
+  void SetUp() override
+  {
+    tc::gLogger_.SetLogCallback(
+        [this](
+            tc::Logger::Level, bool, const char*, int, uint64_t,
+            const char* msg) { messages_.push_back(msg ? msg : ""); });
+  }
+
+  void TearDown() override
+  {
+    tc::gLogger_.SetVerboseLevel(0);
+    tc::gLogger_.SetLogCallback(tc::Logger::LogCallbackFn());
+  }
+
+  std::vector<std::string> messages_;
+};
+
+// The arguments of LOG_VERBOSE_FMT are neither evaluated nor formatted
+// unless its level is on.
+TEST_F(LogMacrosTest, FormatArgumentsOnlyEvaluatedWhenOn)
+{
+  int evaluated = 0;
+  int formatted = 0;
+
+  tc::gLogger_.SetVerboseLevel(1);
+  for (int i = 0; i < 2; ++i) {
+    LOG_VERBOSE_FMT(2, "{} {}", ++evaluated, CountedArg{&formatted});
+  }
+  EXPECT_EQ(evaluated, 0);
+  EXPECT_EQ(formatted, 0);
+  EXPECT_TRUE(messages_.empty());
+
+  tc::gLogger_.SetVerboseLevel(2);
+  LOG_VERBOSE_FMT(2, "{} {}", ++evaluated, CountedArg{&formatted});
+  EXPECT_EQ(evaluated, 1);
+  EXPECT_EQ(formatted, 1);
+  ASSERT_EQ(messages_.size(), 1u);
+  EXPECT_EQ(messages_[0], "1 counted");
+}
+
+// Levels above TRITON_LOG_MAX_VERBOSE are off whatever the verbose level.
+TEST_F(LogMacrosTest, CompilesOutLevelsAboveMax)
+{
+  tc::gLogger_.SetVerboseLevel(5);
+  EXPECT_TRUE(LOG_VERBOSE_IS_ON(1));
+  EXPECT_TRUE(LOG_VERBOSE_IS_ON(2));
+  EXPECT_FALSE(LOG_VERBOSE_IS_ON(3));
+  EXPECT_FALSE(LOG_VERBOSE_IS_ON_FL(3, __FILE__));
+
+  int evaluated = 0;
+  LOG_VERBOSE_FMT(3, "{}", ++evaluated);
+  LOG_VERBOSE(3) << ++evaluated;
+  EXPECT_EQ(evaluated, 0);
+  EXPECT_TRUE(messages_.empty());
+}
+
+}  // namespace
@@ -26,12 +26,24 @@
 
 #include "triton/common/logging.h"
 
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <fstream>
+#include <regex>
+#include <iomanip>
 #include <iostream>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <vector>
 
+#ifndef _WIN32
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
 #include "gtest/gtest.h"
 
 namespace tc = triton::common;
@@ -176,4 +188,753 @@ TEST_F(LogCallbackTest, ThrowingCallbackDoesNotEscapeDestructor)
   });
 }
 
+// Writes the default sink to a file, restores it after each test.
+class LogFormatTest : public ::testing::Test {
+ protected:
+  void SetUp() override
+  {
+    filename_ = ::testing::TempDir() + "log_format_test.log";
+    std::remove(filename_.c_str());
+    ASSERT_TRUE(tc::gLogger_.SetLogFile(filename_).empty());
+  }
+
+  void TearDown() override
+  {
+    tc::gLogger_.SetLogFormat(tc::Logger::Format::kDEFAULT);
+    tc::gLogger_.SetLogFile("");
+    std::remove(filename_.c_str());
+  }
+
+  std::vector<std::string> ReadLines()
+  {
+    std::vector<std::string> lines;
+    std::ifstream file(filename_);
+    for (std::string line; std::getline(file, line);) {
+      lines.push_back(line);
+    }
+    return lines;
+  }
+
+  std::string filename_;
+};
+
+// Logs a message when streamed, while the enclosing message is built.
+struct NestedLog {
+};
+
+std::ostream&
+operator<<(std::ostream& out, const NestedLog&)
+{
+  tc::LogMessage(__FILE__, __LINE__, tc::Logger::Level::kINFO, nullptr, false)
+          .stream()
+      << "inner";
+  return out << "outer";
+}
+
+// Validate the preamble of both formats and the escaping of the message.
+TEST_F(LogFormatTest, FormatsRecords)
+{
+  tc::LogMessage(
+      "/path/to/file.cc", 42, tc::Logger::Level::kWARNING, nullptr, true)
+          .stream()
+      << "a\"b\\c\nd\x01" "e\tf";
+  tc::gLogger_.SetLogFormat(tc::Logger::Format::kISO8601);
+  tc::LogMessage("file.cc", 7, tc::Logger::Level::kERROR, "heading", false)
+          .stream()
+      << "plain \"text\"";
+
+  const auto lines = ReadLines();
+  ASSERT_EQ(lines.size(), 3u);
+  EXPECT_TRUE(std::regex_match(
+      lines[0], std::regex("W[0-9]{4} [0-9]{2}:[0-9]{2}:[0-9]{2}\\.[0-9]{6} "
+                           "[0-9]+ file\\.cc:42\\] .*")))
+      << lines[0];
+  EXPECT_EQ(
+      lines[0].substr(lines[0].find("] ") + 2),
+      "\"a\\\"b\\\\c\\nd\\u0001e\\tf\"");
+  EXPECT_TRUE(std::regex_match(
+      lines[1], std::regex("[0-9]{4}-[0-9]{2}-[0-9]{2}T"
+                           "[0-9]{2}:[0-9]{2}:[0-9]{2}Z "
+                           "E [0-9]+ file\\.cc:7\\] \"heading\"")))
+      << lines[1];
+  EXPECT_EQ(lines[2], "plain \"text\"");
+}
+
+// Validate that JSON records hold every field on a single line, with the
+// message escaped whatever the escaping setting.
+TEST_F(LogFormatTest, FormatsJsonRecords)
+{
+  tc::gLogger_.SetLogFormat(tc::Logger::Format::kJSON);
+  EXPECT_EQ(tc::gLogger_.LogFormatString(), "JSON");
+  tc::LogMessage(
+      "/path/to/file.cc", 42, tc::Logger::Level::kWARNING, nullptr, false)
+          .stream()
+      << "a\"b\nc";
+  tc::LogMessage("file.cc", 7, tc::Logger::Level::kINFO, "head\"ing", true)
+          .SetVerbose()
+          .stream()
+      << "text";
+
+  const auto lines = ReadLines();
+  ASSERT_EQ(lines.size(), 2u);
+  EXPECT_TRUE(std::regex_match(
+      lines[0], std::regex("\\{\"level\":\"WARNING\","
+                           "\"timestamp_us\":[0-9]{16},"
+                           "\"pid\":[0-9]+,\"tid\":[0-9]+,"
+                           "\"file\":\"file\\.cc\",\"line\":42,"
+                           "\"verbose\":false,\"heading\":null,"
+                           "\"message\":\"a\\\\\"b\\\\nc\"\\}")))
+      << lines[0];
+  EXPECT_TRUE(std::regex_match(
+      lines[1], std::regex("\\{\"level\":\"INFO\",.*,\"line\":7,"
+                           "\"verbose\":true,\"heading\":\"head\\\\\"ing\","
+                           "\"message\":\"text\"\\}")))
+      << lines[1];
+}
+
+// Validate that a message logged while another is built is written whole,
+// and that stream state does not leak to the next message of the thread.
+TEST_F(LogFormatTest, NestedMessagesAndStreamState)
+{
+  tc::LogMessage(__FILE__, __LINE__, tc::Logger::Level::kINFO, nullptr, false)
+          .stream()
+      << std::hex << std::setfill('*') << 255 << " " << NestedLog();
+  tc::LogMessage(__FILE__, __LINE__, tc::Logger::Level::kINFO, nullptr, false)
+          .stream()
+      << std::setw(4) << 255;
+
+  const auto lines = ReadLines();
+  ASSERT_EQ(lines.size(), 3u);
+  EXPECT_NE(lines[0].find("logging_test.cc:"), std::string::npos);
+  EXPECT_EQ(lines[0].substr(lines[0].find("] ") + 2), "inner");
+  EXPECT_EQ(lines[1].substr(lines[1].find("] ") + 2), "ff outer");
+  EXPECT_EQ(lines[2].substr(lines[2].find("] ") + 2), " 255");
+}
+
+// The rate limit and the repeat suppression are process-global, restore
+// them after each test.
+class LogSiteTest : public LogFormatTest {
+ protected:
+  void TearDown() override
+  {
+    tc::gLogger_.SetRateLimit(0, std::chrono::seconds(0));
+    tc::gLogger_.SetSuppressRepeats(false);
+    LogFormatTest::TearDown();
+  }
+
+  static void Log(tc::LogSite* site, const std::string& message)
+  {
+    tc::LogMessage(
+        "file.cc", 1, tc::Logger::Level::kWARNING, nullptr, false)
+            .SetSite(site)
+            .stream()
+        << message;
+  }
+
+  std::string Message(const std::string& line)
+  {
+    return line.substr(line.find("] ") + 2);
+  }
+};
+
+// Validate that a call site allows bursts of records then drops and counts
+// the records beyond its rate.
+TEST_F(LogSiteTest, RateLimit)
+{
+  tc::LogSite site;
+  const int64_t hour_ns = 3600LL * 1000000000LL;
+  EXPECT_TRUE(site.Allow(hour_ns, 2));
+  EXPECT_TRUE(site.Allow(hour_ns, 2));
+  EXPECT_FALSE(site.Allow(hour_ns, 2));
+  EXPECT_FALSE(site.Allow(hour_ns, 2));
+  EXPECT_EQ(site.TakeSuppressed(), 2u);
+  EXPECT_EQ(site.TakeSuppressed(), 0u);
+
+  tc::LogSite global_site;
+  EXPECT_TRUE(global_site.Allow());
+  tc::gLogger_.SetRateLimit(1, std::chrono::hours(1));
+  EXPECT_TRUE(global_site.Allow());
+  EXPECT_FALSE(global_site.Allow());
+  Log(&global_site, "allowed");
+  tc::gLogger_.SetRateLimit(0, std::chrono::seconds(0));
+  EXPECT_TRUE(global_site.Allow());
+
+  const auto lines = ReadLines();
+  ASSERT_EQ(lines.size(), 1u);
+  EXPECT_EQ(Message(lines[0]), "allowed [1 similar messages suppressed]");
+}
+
+TEST_F(LogSiteTest, EveryN)
+{
+  tc::LogSite site;
+  std::vector<int> allowed;
+  for (int i = 0; i < 10; ++i) {
+    if (site.EveryN(3)) {
+      allowed.push_back(i);
+    }
+  }
+  EXPECT_EQ(allowed, std::vector<int>({0, 3, 6, 9}));
+
+  // Every occurrence, without dividing by zero
+  EXPECT_TRUE(site.EveryN(0));
+  EXPECT_TRUE(site.EveryN(0));
+  EXPECT_TRUE(site.EveryN(1));
+}
+
+// Validate that repeated records of a call site are summarized once it logs
+// a different one.
+TEST_F(LogSiteTest, SuppressesRepeats)
+{
+  tc::LogSite site;
+  Log(&site, "repeated");
+  Log(&site, "repeated");
+  tc::gLogger_.SetSuppressRepeats(true);
+  for (int i = 0; i < 3; ++i) {
+    Log(&site, "repeated");
+  }
+  Log(&site, "different");
+  Log(&site, "repeated");
+
+  // The first record once enabled is not known to repeat
+  const auto lines = ReadLines();
+  ASSERT_EQ(lines.size(), 6u);
+  EXPECT_EQ(Message(lines[0]), "repeated");
+  EXPECT_EQ(Message(lines[1]), "repeated");
+  EXPECT_EQ(Message(lines[2]), "repeated");
+  EXPECT_EQ(Message(lines[3]), "last message repeated 2 times");
+  EXPECT_EQ(Message(lines[4]), "different");
+  EXPECT_EQ(Message(lines[5]), "repeated");
+}
+
+// Validate the placeholders and escapes of the LOG_VERBOSE_FMT formats.
+TEST(LogFormatToTest, ReplacesPlaceholders)
+{
+  auto format = [](const char* format, const auto&... args) {
+    std::stringstream out;
+    tc::LogFormatTo(out, format, args...);
+    return out.str();
+  };
+  EXPECT_EQ(
+      format("model {} version {}", "simple", 3), "model simple version 3");
+  EXPECT_EQ(format("{}{}", 1, 2.5), "12.5");
+  EXPECT_EQ(format("no placeholder"), "no placeholder");
+  EXPECT_EQ(format("{{}} {{{}}} }}{{", 7), "{} {7} }{");
+  EXPECT_EQ(format("{} {} {", "one"), "one {} {");
+  EXPECT_EQ(format("{}", 1, 2), "1");
+  EXPECT_EQ(format(""), "");
+}
+
+// Validate that values written to the binary log render as the text
+// format writes them, including the character types.
+TEST(LogFormatToTest, BinaryValuesRenderAsText)
+{
+  auto compare = [](const auto& value) {
+    std::stringstream text;
+    tc::LogFormatTo(text, "{}", value);
+    const tc::LogBinaryValue written(value);
+    std::string buffer(written.Size(), '\0');
+    written.Write(&buffer[0]);
+    tc::LogBinaryValue read;
+    EXPECT_EQ(
+        read.Read(buffer.data(), buffer.data() + buffer.size()),
+        buffer.data() + buffer.size());
+    std::stringstream binary;
+    binary << read;
+    EXPECT_EQ(binary.str(), text.str());
+  };
+  compare('A');
+  compare(uint8_t('B'));
+  compare(int8_t('C'));
+  compare(static_cast<signed char>(-1));
+  compare(static_cast<unsigned char>(200));
+  compare(-7);
+  compare(7u);
+  compare(true);
+  compare(2.5);
+  compare("text");
+#if __cplusplus < 202002L
+  // Written as integers, their operator<< is deleted in C++20
+  compare(u'D');
+  compare(U'E');
+  compare(L'F');
+#endif
+}
+
+// The verbose levels are process-global, restore them after each test.
+class VerboseModulesTest : public ::testing::Test {
+ protected:
+  void TearDown() override
+  {
+    tc::gLogger_.SetVerboseLevel(0);
+    tc::gLogger_.SetVerboseModules("");
+  }
+};
+
+// Validate that the first matching pattern sets the level of a file and
+// that other files use the global level.
+TEST_F(VerboseModulesTest, MatchesPatterns)
+{
+  tc::gLogger_.SetVerboseLevel(1);
+  ASSERT_TRUE(tc::gLogger_
+                  .SetVerboseModules(" dynamic_batch*=3, ensemble?=0,en*=2")
+                  .empty());
+  EXPECT_EQ(
+      tc::gLogger_.VerboseModules(), " dynamic_batch*=3, ensemble?=0,en*=2");
+  EXPECT_EQ(tc::gLogger_.VerboseLevel("/src/dynamic_batch_scheduler.cc"), 3u);
+  EXPECT_EQ(tc::gLogger_.VerboseLevel("dynamic_batch.h"), 3u);
+  EXPECT_EQ(tc::gLogger_.VerboseLevel("ensembles.cc"), 0u);
+  EXPECT_EQ(tc::gLogger_.VerboseLevel("ensemble.cc"), 2u);
+  EXPECT_EQ(tc::gLogger_.VerboseLevel("backend_model.cc"), 1u);
+
+  ASSERT_TRUE(tc::gLogger_.SetVerboseModules("").empty());
+  EXPECT_EQ(tc::gLogger_.VerboseLevel("dynamic_batch.h"), 1u);
+}
+
+// Validate that a call site's cached level follows setting changes.
+TEST_F(VerboseModulesTest, CallSiteCacheInvalidated)
+{
+  static tc::LogVerboseSite site("/src/logging_test.cc");
+  EXPECT_EQ(site.Level(), 0u);
+  ASSERT_TRUE(tc::gLogger_.SetVerboseModules("logging_*=2").empty());
+  EXPECT_EQ(site.Level(), 2u);
+  tc::gLogger_.SetVerboseLevel(5);
+  EXPECT_EQ(site.Level(), 2u);
+  ASSERT_TRUE(tc::gLogger_.SetVerboseModules("").empty());
+  EXPECT_EQ(site.Level(), 5u);
+}
+
+TEST_F(VerboseModulesTest, RejectsInvalidSettings)
+{
+  ASSERT_TRUE(tc::gLogger_.SetVerboseModules("a=1").empty());
+  for (const char* modules : {"a", "a=", "=1", "a=x", "a=1,b=-2"}) {
+    EXPECT_FALSE(tc::gLogger_.SetVerboseModules(modules).empty()) << modules;
+  }
+  // Invalid settings leave the current ones
+  EXPECT_EQ(tc::gLogger_.VerboseModules(), "a=1");
+}
+
+// The asynchronous mode is process-global, disable it and restore the
+// default sink after each test.
+class AsyncLogTest : public ::testing::Test {
+ protected:
+  void SetUp() override
+  {
+    filename_ = ::testing::TempDir() + "async_log_test.log";
+    std::remove(filename_.c_str());
+    ASSERT_TRUE(tc::gLogger_.SetLogFile(filename_).empty());
+  }
+
+  void TearDown() override
+  {
+    tc::gLogger_.SetAsync(false);
+    tc::gLogger_.SetLogFile("");
+    std::remove(filename_.c_str());
+  }
+
+  std::vector<std::string> ReadLines()
+  {
+    std::vector<std::string> lines;
+    std::ifstream file(filename_);
+    for (std::string line; std::getline(file, line);) {
+      lines.push_back(line);
+    }
+    return lines;
+  }
+
+  std::string filename_;
+};
+
+// Validate that records logged by several threads are all written once
+// flushed, each thread's records in order.
+TEST_F(AsyncLogTest, WritesAllRecordsInOrder)
+{
+  ASSERT_TRUE(tc::gLogger_.SetAsync(true, 16).empty());
+  EXPECT_TRUE(tc::gLogger_.IsAsync());
+
+  constexpr int kThreads = 4;
+  constexpr int kRecords = 500;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([t]() {
+      for (int i = 0; i < kRecords; ++i) {
+        tc::LogMessage(
+            __FILE__, __LINE__, tc::Logger::Level::kINFO, nullptr, false)
+                .stream()
+            << "async " << t << " " << i;
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  tc::gLogger_.Flush();
+
+  std::vector<int> next(kThreads, 0);
+  for (const auto& line : ReadLines()) {
+    const size_t pos = line.find("] async ");
+    ASSERT_NE(pos, std::string::npos) << line;
+    std::istringstream fields(line.substr(pos + 8));
+    int t, i;
+    fields >> t >> i;
+    EXPECT_EQ(i, next[t]);
+    next[t] = i + 1;
+  }
+  for (int t = 0; t < kThreads; ++t) {
+    EXPECT_EQ(next[t], kRecords);
+  }
+}
+
+// Validate that records longer than the inline buffer of the ring are
+// written whole.
+TEST_F(AsyncLogTest, WritesLongRecords)
+{
+  ASSERT_TRUE(tc::gLogger_.SetAsync(true).empty());
+  const std::string message(4096, 'x');
+  tc::gLogger_.Log(message, tc::Logger::Level::kINFO);
+  tc::gLogger_.Flush();
+  const auto lines = ReadLines();
+  ASSERT_EQ(lines.size(), 1u);
+  EXPECT_EQ(lines[0], message);
+}
+
+// Validate that records discarded by the drop policies are counted and the
+// others written.
+TEST_F(AsyncLogTest, DropPoliciesCountDroppedRecords)
+{
+  for (const auto policy : {tc::Logger::OverflowPolicy::kDROP_NEWEST,
+                            tc::Logger::OverflowPolicy::kDROP_OLDEST}) {
+    ASSERT_TRUE(tc::gLogger_.SetAsync(true, 2, policy).empty());
+    const size_t written = ReadLines().size();
+    const uint64_t dropped = tc::gLogger_.DroppedCount();
+    constexpr uint64_t kRecords = 2000;
+    for (uint64_t i = 0; i < kRecords; ++i) {
+      tc::gLogger_.Log("dropped", tc::Logger::Level::kINFO);
+    }
+    tc::gLogger_.Flush();
+    EXPECT_EQ(
+        (ReadLines().size() - written) +
+            (tc::gLogger_.DroppedCount() - dropped),
+        kRecords);
+    ASSERT_TRUE(tc::gLogger_.SetAsync(false).empty());
+  }
+}
+
+// Validate that the asynchronous mode can't be enabled twice or without
+// room for records.
+TEST_F(AsyncLogTest, RejectsInvalidSettings)
+{
+  EXPECT_FALSE(tc::gLogger_.SetAsync(true, 0).empty());
+  EXPECT_FALSE(tc::gLogger_.IsAsync());
+  ASSERT_TRUE(tc::gLogger_.SetAsync(true).empty());
+  EXPECT_FALSE(tc::gLogger_.SetAsync(true).empty());
+  EXPECT_TRUE(tc::gLogger_.SetAsync(false).empty());
+  EXPECT_FALSE(tc::gLogger_.IsAsync());
+}
+
+#ifndef _WIN32
+// Rotates the log file of the default sink, disables the rotation and
+// removes the rotated files after each test.
+class LogRotationTest : public ::testing::Test {
+ protected:
+  void SetUp() override
+  {
+    filename_ = ::testing::TempDir() + "log_rotation_test.log";
+    RemoveFiles();
+    ASSERT_TRUE(tc::gLogger_.SetLogFile(filename_).empty());
+  }
+
+  void TearDown() override
+  {
+    tc::gLogger_.SetRotateOnSighup(false);
+    tc::gLogger_.SetLogRotation(0, std::chrono::seconds(0), 0);
+    tc::gLogger_.SetAsync(false);
+    tc::gLogger_.SetLogFile("");
+    RemoveFiles();
+  }
+
+  void RemoveFiles()
+  {
+    for (const char* suffix : {"", ".1", ".2", ".3", ".1.gz", ".1.zst"}) {
+      std::remove((filename_ + suffix).c_str());
+    }
+  }
+
+  // Name of the log file rotated 'index' times ago.
+  std::string Rotated(size_t index, const char* suffix = "")
+  {
+    return filename_ + "." + std::to_string(index) + suffix;
+  }
+
+  static bool Exists(const std::string& filename)
+  {
+    return std::ifstream(filename).good();
+  }
+
+  // Wait up to 10 seconds for 'filename' to exist.
+  static bool WaitFor(const std::string& filename)
+  {
+    const auto deadline =
+        std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (!Exists(filename)) {
+      if (std::chrono::steady_clock::now() > deadline) {
+        return false;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return true;
+  }
+
+  static std::vector<std::string> ReadLines(const std::string& filename)
+  {
+    std::vector<std::string> lines;
+    std::ifstream file(filename);
+    for (std::string line; std::getline(file, line);) {
+      lines.push_back(line);
+    }
+    return lines;
+  }
+
+  // Stop the rotation, which retires the rotated files.
+  static void StopRotation()
+  {
+    ASSERT_TRUE(
+        tc::gLogger_.SetLogRotation(0, std::chrono::seconds(0), 0).empty());
+  }
+
+  std::string filename_;
+};
+
+// Validate that the log file is rotated once it reaches the maximum size,
+// keeping the newest rotated files, in both modes.
+TEST_F(LogRotationTest, RotatesBySize)
+{
+  for (const bool async : {false, true}) {
+    ASSERT_TRUE(tc::gLogger_.SetAsync(async).empty());
+    // Each record is 10 bytes with its newline, a file holds 3 of them
+    ASSERT_TRUE(
+        tc::gLogger_.SetLogRotation(30, std::chrono::seconds(0), 2).empty());
+    for (int i = 0; i < 10; ++i) {
+      tc::gLogger_.Log(
+          "record " + std::to_string(i) + " ", tc::Logger::Level::kINFO);
+      // The asynchronous writer checks the size after each batch
+      tc::gLogger_.Flush();
+    }
+    StopRotation();
+    ASSERT_TRUE(tc::gLogger_.SetAsync(false).empty());
+
+    EXPECT_FALSE(Exists(Rotated(3))) << async;
+    EXPECT_EQ(
+        ReadLines(Rotated(2)),
+        std::vector<std::string>({"record 3 ", "record 4 ", "record 5 "}))
+        << async;
+    EXPECT_EQ(
+        ReadLines(Rotated(1)),
+        std::vector<std::string>({"record 6 ", "record 7 ", "record 8 "}))
+        << async;
+    EXPECT_EQ(ReadLines(filename_), std::vector<std::string>({"record 9 "}))
+        << async;
+    RemoveFiles();
+    ASSERT_TRUE(tc::gLogger_.SetLogFile(filename_).empty());
+  }
+}
+
+// Validate the rotation through the API, on SIGHUP and once the interval
+// elapsed, and that empty log files are not rotated.
+TEST_F(LogRotationTest, RotatesOnRequest)
+{
+  EXPECT_FALSE(tc::gLogger_.RotateLogFile().empty());
+  ASSERT_TRUE(
+      tc::gLogger_.SetLogRotation(0, std::chrono::seconds(1), 3).empty());
+  ASSERT_TRUE(tc::gLogger_.SetRotateOnSighup(true).empty());
+
+  tc::gLogger_.Log("first", tc::Logger::Level::kINFO);
+  ASSERT_TRUE(tc::gLogger_.RotateLogFile().empty());
+  ASSERT_TRUE(WaitFor(Rotated(1)));
+  tc::gLogger_.Log("second", tc::Logger::Level::kINFO);
+  ASSERT_EQ(std::raise(SIGHUP), 0);
+  ASSERT_TRUE(WaitFor(Rotated(2)));
+  tc::gLogger_.Log("third", tc::Logger::Level::kINFO);
+  ASSERT_TRUE(WaitFor(Rotated(3)));
+  // Nothing logged since
+  ASSERT_TRUE(tc::gLogger_.RotateLogFile().empty());
+  StopRotation();
+
+  EXPECT_EQ(ReadLines(Rotated(3)), std::vector<std::string>({"first"}));
+  EXPECT_EQ(ReadLines(Rotated(2)), std::vector<std::string>({"second"}));
+  EXPECT_EQ(ReadLines(Rotated(1)), std::vector<std::string>({"third"}));
+  EXPECT_TRUE(ReadLines(filename_).empty());
+}
+
+// Validate that the rotated log file is compressed with the libraries the
+// logger is built with.
+TEST_F(LogRotationTest, CompressesRotatedFiles)
+{
+  const std::vector<std::pair<tc::Logger::Compression, const char*>> formats{
+      {tc::Logger::Compression::kGZIP, ".gz"},
+      {tc::Logger::Compression::kZSTD, ".zst"}};
+  for (const auto& format : formats) {
+    if (!tc::gLogger_
+             .SetLogRotation(0, std::chrono::seconds(0), 1, format.first)
+             .empty()) {
+      std::cout << "Skipping unavailable " << format.second << std::endl;
+      continue;
+    }
+    tc::gLogger_.Log("compressed", tc::Logger::Level::kINFO);
+    ASSERT_TRUE(tc::gLogger_.RotateLogFile().empty());
+    StopRotation();
+    EXPECT_FALSE(Exists(Rotated(1))) << format.second;
+    std::ifstream file(Rotated(1, format.second), std::ios::binary);
+    char magic[2] = {0, 0};
+    file.read(magic, sizeof(magic));
+    const char* expected =
+        (format.first == tc::Logger::Compression::kGZIP) ? "\x1f\x8b"
+                                                         : "\x28\xb5";
+    EXPECT_EQ(std::string(magic, 2), std::string(expected, 2))
+        << format.second;
+  }
+}
+
+// Writes the binary log to a temporary directory, removed after each test.
+class BinaryLogTest : public ::testing::Test {
+ protected:
+  void SetUp() override
+  {
+    directory_ = ::testing::TempDir() + "binary_log_test";
+    RemoveDirectory();
+    ASSERT_EQ(mkdir(directory_.c_str(), 0755), 0);
+  }
+
+  void TearDown() override
+  {
+    tc::gLogger_.SetBinaryLog("");
+    RemoveDirectory();
+  }
+
+  void RemoveDirectory()
+  {
+    for (const auto& name : Files("")) {
+      std::remove((directory_ + "/" + name).c_str());
+    }
+    rmdir(directory_.c_str());
+  }
+
+  // Names of the files of the binary log ending with 'suffix'.
+  std::vector<std::string> Files(const std::string& suffix)
+  {
+    std::vector<std::string> names;
+    DIR* dir = opendir(directory_.c_str());
+    if (dir == nullptr) {
+      return names;
+    }
+    for (struct dirent* entry; (entry = readdir(dir)) != nullptr;) {
+      const std::string name = entry->d_name;
+      if ((name != ".") && (name != "..") && (name.size() >= suffix.size()) &&
+          (name.compare(name.size() - suffix.size(), suffix.size(), suffix) ==
+           0)) {
+        names.push_back(name);
+      }
+    }
+    closedir(dir);
+    return names;
+  }
+
+  std::string Read(const std::string& name)
+  {
+    std::ifstream file(directory_ + "/" + name, std::ios::binary);
+    std::stringstream content;
+    content << file.rdbuf();
+    return content.str();
+  }
+
+  // Records of the ring file of the calling thread, as their site followed
+  // by their values.
+  std::vector<std::string> ReadRecords()
+  {
+    const std::vector<std::string> rings = Files(".blog");
+    EXPECT_EQ(rings.size(), 1u);
+    std::vector<std::string> records;
+    if (rings.size() != 1) {
+      return records;
+    }
+    const std::string content = Read(rings[0]);
+    EXPECT_TRUE(tc::ForEachLogBinaryRecord(
+        content.data(), content.size(),
+        [&records](
+            const tc::LogBinaryRecordHeader& header, const char* in,
+            const char* end) {
+          std::stringstream record;
+          record << header.site;
+          tc::LogBinaryValue value;
+          while ((in = value.Read(in, end)) != nullptr) {
+            record << ' ' << value.Tag() << ':' << value;
+          }
+          records.push_back(record.str());
+        }));
+    return records;
+  }
+
+  std::string directory_;
+};
+
+// Validate that the records are written to the ring file of the thread
+// with the raw values of their arguments, and the call sites to the sites
+// file.
+TEST_F(BinaryLogTest, WritesRecords)
+{
+  static tc::LogFormatSite site("binary_log.cc", 42);
+  ASSERT_TRUE(tc::gLogger_.SetBinaryLog(directory_, 4096).empty());
+  ASSERT_TRUE(tc::gLogger_.IsBinary());
+  tc::LogMessage("logging_test.cc", 7, tc::Logger::Level::kWARNING, "title")
+          .stream()
+      << "message " << 1;
+  tc::LogVerboseFormat(site, "{} of {}", "model", 3, 2.5, true, 'x');
+  tc::LogVerboseFormat(site, "{} of {}", std::string("other"), -1u);
+
+  const std::string id = std::to_string(site.Id("{} of {}"));
+  EXPECT_EQ(
+      ReadRecords(),
+      std::vector<std::string>(
+          {"0 u:1 b:0 b:1 b:1 i:7 s:logging_test.cc s:title s:message 1",
+           id + " s:model i:3 d:2.5 b:1 c:x",
+           id + " s:other u:4294967295"}));
+  const std::vector<std::string> sites = Files(".sites");
+  ASSERT_EQ(sites.size(), 1u);
+  const std::string content = Read(sites[0]);
+  EXPECT_EQ(content.compare(0, 8, "TRTNSITE"), 0);
+  EXPECT_NE(content.find("binary_log.cc"), std::string::npos);
+  EXPECT_NE(content.find("{} of {}"), std::string::npos);
+
+  ASSERT_TRUE(tc::gLogger_.SetBinaryLog("").empty());
+  EXPECT_FALSE(tc::gLogger_.IsBinary());
+}
+
+// Validate that a full ring keeps the most recent records.
+TEST_F(BinaryLogTest, OverwritesOldestRecords)
+{
+  static tc::LogFormatSite site("binary_log.cc", 43);
+  ASSERT_TRUE(tc::gLogger_.SetBinaryLog(directory_, 4096).empty());
+  for (int i = 0; i < 1000; ++i) {
+    tc::LogVerboseFormat(site, "record {}", i);
+  }
+  const std::vector<std::string> records = ReadRecords();
+  ASSERT_GT(records.size(), 100u);
+  ASSERT_LT(records.size(), 1000u);
+  const std::string id = std::to_string(site.Id("record {}"));
+  for (size_t i = 0; i < records.size(); ++i) {
+    EXPECT_EQ(
+        records[i],
+        id + " i:" + std::to_string(1000 - records.size() + i));
+  }
+}
+
+// Validate the binary log settings.
+TEST_F(BinaryLogTest, RejectsInvalidSettings)
+{
+  EXPECT_FALSE(tc::gLogger_.SetBinaryLog(directory_, 1024).empty());
+  EXPECT_FALSE(
+      tc::gLogger_.SetBinaryLog(directory_ + "/missing", 4096).empty());
+  EXPECT_FALSE(tc::gLogger_.IsBinary());
+}
+#endif  // !_WIN32
+
 }  // namespace
@@ -0,0 +1,263 @@
+// Copyright 2026, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "triton/common/sync_queue.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "triton/common/lock_free_sync_queue.h"
+
+namespace tc = triton::common;
+
+namespace {
+
+TEST(SyncQueueTest, FifoOrder)
+{
+  tc::SyncQueue<int> queue;
+  EXPECT_TRUE(queue.Empty());
+  for (int i = 0; i < 10; ++i) {
+    queue.Put(i);
+  }
+  EXPECT_FALSE(queue.Empty());
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ(queue.Get(), i);
+  }
+  EXPECT_TRUE(queue.Empty());
+}
+
+TEST(SyncQueueTest, BoundedTryAndTimedOperations)
+{
+  tc::SyncQueue<int> queue(2);
+  EXPECT_EQ(queue.Capacity(), 2u);
+  EXPECT_TRUE(queue.TryPut(1));
+  EXPECT_TRUE(queue.Put(2));
+  EXPECT_FALSE(queue.TryPut(3));
+  EXPECT_FALSE(queue.PutFor(std::chrono::milliseconds(10), 3));
+  EXPECT_EQ(queue.Size(), 2u);
+
+  int item = 0;
+  EXPECT_TRUE(queue.TryGet(&item));
+  EXPECT_EQ(item, 1);
+  EXPECT_TRUE(queue.GetFor(std::chrono::milliseconds(10), &item));
+  EXPECT_EQ(item, 2);
+  EXPECT_FALSE(queue.TryGet(&item));
+  EXPECT_FALSE(queue.GetFor(std::chrono::milliseconds(10), &item));
+  EXPECT_TRUE(queue.PutUntil(
+      std::chrono::steady_clock::now() + std::chrono::milliseconds(10), 3));
+}
+
+// Validate that a producer blocked on a full queue resumes once a consumer
+// makes room.
+TEST(SyncQueueTest, PutBlocksWhileFull)
+{
+  tc::SyncQueue<int> queue(1);
+  queue.Put(1);
+  std::atomic<bool> put_done{false};
+  std::thread producer([&]() {
+    queue.Put(2);
+    put_done = true;
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  EXPECT_FALSE(put_done);
+  EXPECT_EQ(queue.Get(), 1);
+  producer.join();
+  EXPECT_TRUE(put_done);
+  EXPECT_EQ(queue.Get(), 2);
+}
+
+// Validate that Close() wakes blocked producers and consumers, rejects new
+// items and still lets consumers drain what was queued.
+TEST(SyncQueueTest, CloseWakesWaiters)
+{
+  tc::SyncQueue<std::unique_ptr<int>> empty_queue;
+  std::thread consumer([&]() {
+    std::unique_ptr<int> item;
+    EXPECT_FALSE(empty_queue.Get(&item));
+  });
+
+  tc::SyncQueue<int> full_queue(1);
+  full_queue.Put(1);
+  std::thread producer([&]() { EXPECT_FALSE(full_queue.Put(2)); });
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  empty_queue.Close();
+  full_queue.Close();
+  consumer.join();
+  producer.join();
+
+  EXPECT_TRUE(full_queue.IsClosed());
+  EXPECT_FALSE(full_queue.TryPut(3));
+  int item = 0;
+  EXPECT_TRUE(full_queue.TryGet(&item));
+  EXPECT_EQ(item, 1);
+  EXPECT_FALSE(full_queue.Get(&item));
+  EXPECT_FALSE(full_queue.GetFor(std::chrono::seconds(10), &item));
+}
+
+TEST(SyncQueueTest, BatchOperations)
+{
+  tc::SyncQueue<int> queue;
+  std::vector<int> items{0, 1, 2, 3, 4};
+  EXPECT_EQ(queue.PutBatch(items), 5u);
+
+  std::vector<int> batch;
+  EXPECT_EQ(queue.GetBatch(3, std::chrono::milliseconds(10), &batch), 3u);
+  EXPECT_EQ(batch, (std::vector<int>{0, 1, 2}));
+  // Returns what is available without waiting for 'max_items'.
+  EXPECT_EQ(queue.GetBatch(3, std::chrono::milliseconds(10), &batch), 2u);
+  EXPECT_EQ(batch, (std::vector<int>{0, 1, 2, 3, 4}));
+  // Times out when nothing arrives.
+  EXPECT_EQ(queue.GetBatch(3, std::chrono::milliseconds(10), &batch), 0u);
+}
+
+// Validate that a batch larger than the capacity is added in runs as the
+// consumer makes room, preserving order.
+TEST(SyncQueueTest, PutBatchLargerThanCapacity)
+{
+  tc::SyncQueue<std::unique_ptr<int>> queue(2);
+  std::thread producer([&queue]() {
+    std::vector<std::unique_ptr<int>> items;
+    for (int i = 0; i < 7; ++i) {
+      items.emplace_back(new int(i));
+    }
+    EXPECT_EQ(queue.PutBatch(items), 7u);
+  });
+
+  std::vector<std::unique_ptr<int>> received;
+  while (received.size() < 7) {
+    queue.GetBatch(4, std::chrono::seconds(10), &received);
+  }
+  producer.join();
+  for (int i = 0; i < 7; ++i) {
+    EXPECT_EQ(*received[i], i);
+  }
+}
+
+// Validate that async waiters are handed items in order and released by
+// Close().
+TEST(SyncQueueTest, AsyncWaiters)
+{
+  using Waiter = tc::SyncQueue<int>::AsyncWaiter;
+  struct CountingWaiter : public Waiter {
+    int* notified;
+  };
+  int notified = 0;
+  tc::SyncQueue<int> queue;
+  Waiter ready;
+  queue.Put(1);
+  ASSERT_TRUE(queue.GetOrWait(&ready));
+  EXPECT_EQ(ready.item, 1);
+
+  std::array<CountingWaiter, 4> waiters;
+  for (auto& waiter : waiters) {
+    waiter.notify = [](Waiter* self) {
+      ++*static_cast<CountingWaiter*>(self)->notified;
+    };
+    waiter.notified = &notified;
+    ASSERT_FALSE(queue.GetOrWait(&waiter));
+  }
+  queue.Put(2);
+  EXPECT_EQ(notified, 1);
+  EXPECT_EQ(waiters[0].item, 2);
+  EXPECT_FALSE(waiters[1].item.has_value());
+  std::vector<int> batch{3, 4};
+  EXPECT_EQ(queue.PutBatch(batch), 2u);
+  EXPECT_EQ(waiters[1].item, 3);
+  EXPECT_EQ(waiters[2].item, 4);
+  EXPECT_TRUE(queue.Empty());
+  queue.Close();
+  EXPECT_EQ(notified, 4);
+  EXPECT_FALSE(waiters[3].item.has_value());
+
+  Waiter closed;
+  EXPECT_TRUE(queue.GetOrWait(&closed));
+  EXPECT_FALSE(closed.item.has_value());
+}
+
+TEST(LockFreeSyncQueueTest, CapacityAndTryOperations)
+{
+  tc::LockFreeSyncQueue<std::unique_ptr<int>> queue(3);
+  // Capacity is rounded up to a power of two.
+  EXPECT_EQ(queue.Capacity(), 4u);
+  EXPECT_TRUE(queue.Empty());
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_TRUE(queue.TryPut(std::unique_ptr<int>(new int(i))));
+  }
+  EXPECT_FALSE(queue.TryPut(std::unique_ptr<int>(new int(4))));
+
+  std::unique_ptr<int> item;
+  for (int i = 0; i < 4; ++i) {
+    ASSERT_TRUE(queue.TryGet(&item));
+    EXPECT_EQ(*item, i);
+  }
+  EXPECT_FALSE(queue.TryGet(&item));
+  EXPECT_TRUE(queue.Empty());
+}
+
+// Validate that every item is delivered exactly once with several producers
+// and consumers, with a capacity small enough that both sides park.
+TEST(LockFreeSyncQueueTest, MultiProducerMultiConsumer)
+{
+  constexpr int kProducers = 4;
+  constexpr int kConsumers = 4;
+  constexpr int kItemsPerProducer = 20000;
+  tc::LockFreeSyncQueue<int> queue(16, 16 /* spin_count */);
+
+  std::vector<int> seen(kProducers * kItemsPerProducer, 0);
+  std::vector<std::thread> threads;
+  for (int c = 0; c < kConsumers; ++c) {
+    threads.emplace_back([&queue, &seen]() {
+      for (int i = 0; i < kProducers * kItemsPerProducer / kConsumers; ++i) {
+        // Each slot is written by exactly one consumer if delivery is
+        // exactly-once, so no synchronization is needed on 'seen'.
+        seen[queue.Get()]++;
+      }
+    });
+  }
+  for (int p = 0; p < kProducers; ++p) {
+    threads.emplace_back([&queue, p]() {
+      for (int i = 0; i < kItemsPerProducer; ++i) {
+        queue.Put(p * kItemsPerProducer + i);
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  EXPECT_TRUE(queue.Empty());
+  for (const int count : seen) {
+    ASSERT_EQ(count, 1);
+  }
+}
+
+}  // namespace
@@ -0,0 +1,1222 @@
+// Copyright 2026, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "triton/common/thread_pool.h"
+
+#include <sched.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <fstream>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "triton/common/coroutine.h"
+#include "triton/common/parallel_for.h"
+#include "triton/common/strand_executor.h"
+#include "triton/common/thread_pool_metrics.h"
+#include "triton/common/timer_wheel.h"
+
+namespace tc = triton::common;
+
+// Count the heap allocations made by each thread, to validate the
+// allocation-free paths of the pool.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+thread_local size_t tls_allocation_count = 0;
+
+void*
+operator new(size_t size)
+{
+  ++tls_allocation_count;
+  void* ptr = std::malloc(size ? size : 1);
+  if (ptr == nullptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+void
+operator delete(void* ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void
+operator delete(void* ptr, size_t) noexcept
+{
+  std::free(ptr);
+}
+
+namespace {
+
+// Occupies a single worker of 'pool' until Release() is called so that
+// tasks can be queued in a known state. The destructor releases the worker
+// and waits for it to leave the gate.
+class WorkerGate {
+ public:
+  explicit WorkerGate(tc::ThreadPool& pool)
+  {
+    pool.Enqueue([this]() {
+      blocked_ = true;
+      while (!released_) {
+        std::this_thread::yield();
+      }
+      finished_ = true;
+    });
+    while (!blocked_) {
+      std::this_thread::yield();
+    }
+  }
+
+  ~WorkerGate()
+  {
+    Release();
+    while (!finished_) {
+      std::this_thread::yield();
+    }
+  }
+
+  void Release() { released_ = true; }
+
+ private:
+  std::atomic<bool> blocked_{false};
+  std::atomic<bool> released_{false};
+  std::atomic<bool> finished_{false};
+};
+
+// Records the priority levels of its tasks in the order they run.
+class PriorityRecorder {
+ public:
+  // Enqueue a task at 'level' that records 'level' when run.
+  void Enqueue(tc::ThreadPool& pool, uint32_t level)
+  {
+    pool.Enqueue(
+        [this, level]() {
+          std::lock_guard<std::mutex> lk(mu_);
+          order_.push_back(level);
+          cv_.notify_all();
+        },
+        level);
+  }
+
+  // Wait for 'count' tasks to run and return their levels in run order.
+  std::vector<uint32_t> Wait(size_t count)
+  {
+    std::unique_lock<std::mutex> lk(mu_);
+    cv_.wait(lk, [this, count]() { return order_.size() >= count; });
+    return order_;
+  }
+
+ private:
+  std::mutex mu_;
+  std::condition_variable cv_;
+  std::vector<uint32_t> order_;
+};
+
+TEST(ThreadPoolTest, ZeroThreadsThrows)
+{
+  EXPECT_THROW(tc::ThreadPool pool(0), std::invalid_argument);
+}
+
+// Validate that every queued task runs before the pool is destroyed.
+TEST(ThreadPoolTest, RunsAllTasksBeforeDestruction)
+{
+  std::atomic<int> count{0};
+  {
+    tc::ThreadPool pool(4);
+    EXPECT_EQ(pool.Size(), 4u);
+    for (int i = 0; i < 1000; ++i) {
+      pool.Enqueue([&count]() { count++; });
+    }
+  }
+  EXPECT_EQ(count, 1000);
+}
+
+// Validate that workers draining several tasks per wakeup still run every
+// task, in both scheduling modes.
+TEST(ThreadPoolTest, DrainsMultipleTasksPerWakeup)
+{
+  for (const bool work_stealing : {false, true}) {
+    std::atomic<int> count{0};
+    {
+      tc::ThreadPool::Options options;
+      options.thread_count = 3;
+      options.work_stealing = work_stealing;
+      options.max_tasks_per_wakeup = 8;
+      tc::ThreadPool pool(options);
+      for (int i = 0; i < 1000; ++i) {
+        pool.Enqueue([&count]() { count++; });
+      }
+    }
+    EXPECT_EQ(count, 1000);
+  }
+}
+
+// Validate that parked and spinning workers are woken for tasks enqueued one
+// at a time, so that workers go idle between tasks.
+TEST(ThreadPoolTest, WakesIdleWorkers)
+{
+  for (const bool work_stealing : {false, true}) {
+    for (const uint32_t spin_count : {0u, 1024u}) {
+      tc::ThreadPool::Options options;
+      options.thread_count = 2;
+      options.work_stealing = work_stealing;
+      options.spin_count = spin_count;
+      tc::ThreadPool pool(options);
+      std::atomic<int> count{0};
+      for (int i = 1; i <= 200; ++i) {
+        pool.Enqueue([&count]() { count++; });
+        while (count != i) {
+          std::this_thread::yield();
+        }
+        if ((i % 50) == 0) {
+          // Long enough for the workers to park
+          std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+      }
+      EXPECT_EQ(count, 200);
+    }
+  }
+}
+
+TEST(ThreadPoolTest, InvalidPriorityOptionsThrow)
+{
+  tc::ThreadPool::Options options;
+  options.priority_levels = 2;
+  // Default priority level must be in range
+  EXPECT_THROW(tc::ThreadPool pool(options), std::invalid_argument);
+  options.default_priority_level = 1;
+  options.priority_weights = {1};
+  EXPECT_THROW(tc::ThreadPool pool(options), std::invalid_argument);
+  options.priority_weights.clear();
+  options.work_stealing = true;
+  EXPECT_THROW(tc::ThreadPool pool(options), std::invalid_argument);
+}
+
+// Validate that with the strict policy the highest priority level always
+// runs first, and that per-level queue sizes are reported.
+TEST(ThreadPoolTest, StrictPriorityOrder)
+{
+  tc::ThreadPool::Options options;
+  options.priority_levels = 3;
+  options.default_priority_level = 3;
+  PriorityRecorder recorder;
+  tc::ThreadPool pool(options);
+
+  WorkerGate gate(pool);
+  for (const uint32_t level : {3, 2, 1, 3, 2, 1}) {
+    recorder.Enqueue(pool, level);
+  }
+  // Invalid level falls back to the default level
+  recorder.Enqueue(pool, 7);
+  EXPECT_EQ(pool.TaskQueueSize(), 7u);
+  EXPECT_EQ(pool.TaskQueueSize(1), 2u);
+  EXPECT_EQ(pool.TaskQueueSize(3), 3u);
+  EXPECT_EQ(pool.TaskQueueSize(4), 0u);
+
+  gate.Release();
+  EXPECT_EQ(recorder.Wait(7), (std::vector<uint32_t>{1, 1, 2, 2, 3, 3, 7}));
+}
+
+// Validate that the weighted policy shares the worker between levels in
+// proportion to their weights.
+TEST(ThreadPoolTest, WeightedPriorityShares)
+{
+  tc::ThreadPool::Options options;
+  options.priority_levels = 2;
+  options.default_priority_level = 2;
+  options.priority_policy = tc::ThreadPool::PriorityPolicy::kWEIGHTED;
+  options.priority_weights = {3, 1};
+  PriorityRecorder recorder;
+  tc::ThreadPool pool(options);
+
+  WorkerGate gate(pool);
+  for (int i = 0; i < 40; ++i) {
+    recorder.Enqueue(pool, 1);
+    recorder.Enqueue(pool, 2);
+  }
+  gate.Release();
+  const std::vector<uint32_t> order = recorder.Wait(80);
+
+  ASSERT_EQ(order.size(), 80u);
+  size_t high = 0;
+  for (size_t i = 0; i < 40; ++i) {
+    high += (order[i] == 1) ? 1 : 0;
+  }
+  EXPECT_GE(high, 29u);
+  EXPECT_LE(high, 31u);
+}
+
+// Validate that a low priority task that waited past the aging threshold
+// runs ahead of newer high priority tasks.
+TEST(ThreadPoolTest, AgingPreventsStarvation)
+{
+  tc::ThreadPool::Options options;
+  options.priority_levels = 2;
+  options.default_priority_level = 2;
+  options.aging_threshold = std::chrono::milliseconds(5);
+  PriorityRecorder recorder;
+  tc::ThreadPool pool(options);
+
+  WorkerGate gate(pool);
+  recorder.Enqueue(pool, 2);
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  recorder.Enqueue(pool, 1);
+  gate.Release();
+  EXPECT_EQ(recorder.Wait(2), (std::vector<uint32_t>{2, 1}));
+}
+
+TEST(InlineTaskTest, StoresSmallCallablesInline)
+{
+  int value = 0;
+  std::unique_ptr<int> owned(new int(5));
+  // Move-only capture
+  tc::InlineTask small(
+      [&value, owned = std::move(owned)]() { value = *owned; });
+  EXPECT_TRUE(small);
+  EXPECT_TRUE(small.StoredInline());
+  tc::InlineTask moved(std::move(small));
+  EXPECT_FALSE(small);
+  moved();
+  EXPECT_EQ(value, 5);
+
+  std::array<char, 2 * tc::InlineTask::kInlineCapacity> big{};
+  big[0] = 7;
+  tc::InlineTask large([&value, big]() { value = big[0]; });
+  EXPECT_FALSE(large.StoredInline());
+  large();
+  EXPECT_EQ(value, 7);
+
+  // An empty std::function gives an empty task
+  EXPECT_FALSE(tc::InlineTask(std::function<void()>()));
+}
+
+TEST(ThreadPoolTest, SubmitReturnsResults)
+{
+  tc::ThreadPool pool(2);
+  auto sum = pool.Submit([](int a, int b) { return a + b; }, 2, 3);
+  auto text = pool.Submit([]() { return std::string("done"); });
+  std::atomic<bool> ran{false};
+  auto nothing = pool.Submit([&ran]() { ran = true; });
+  auto failure =
+      pool.Submit([]() -> int { throw std::runtime_error("task failed"); });
+
+  EXPECT_EQ(sum.Get(), 5);
+  EXPECT_FALSE(sum.Valid());
+  EXPECT_EQ(text.Get(), "done");
+  nothing.Get();
+  EXPECT_TRUE(ran);
+  EXPECT_THROW(failure.Get(), std::runtime_error);
+}
+
+// Validate that a future can outlive the pool that produced it.
+TEST(ThreadPoolTest, FutureOutlivesPool)
+{
+  tc::TaskFuture<int> future;
+  {
+    tc::ThreadPool pool(1);
+    future = pool.Submit([]() { return 42; });
+  }
+  EXPECT_TRUE(future.IsReady());
+  EXPECT_EQ(future.Get(), 42);
+}
+
+// Validate that in steady state submitting tasks and waiting for their
+// results does not allocate on the submitting thread.
+TEST(ThreadPoolTest, SubmitDoesNotAllocateInSteadyState)
+{
+  for (const bool work_stealing : {false, true}) {
+    tc::ThreadPool::Options options;
+    options.thread_count = 2;
+    options.work_stealing = work_stealing;
+    tc::ThreadPool pool(options);
+
+    std::vector<tc::TaskFuture<int>> futures;
+    futures.reserve(100);
+    auto round = [&]() {
+      for (int i = 0; i < 100; ++i) {
+        futures.emplace_back(pool.Submit([i]() { return i; }));
+      }
+      int sum = 0;
+      for (auto& future : futures) {
+        sum += future.Get();
+      }
+      futures.clear();
+      // The workers return the shared states to the free list once their
+      // tasks finished, before the next round needs them
+      EXPECT_TRUE(pool.Drain());
+      return sum;
+    };
+    // Warm up the free lists and the queue storage
+    EXPECT_EQ(round(), 4950);
+
+    const size_t before = tls_allocation_count;
+    for (int r = 0; r < 10; ++r) {
+      EXPECT_EQ(round(), 4950);
+    }
+    EXPECT_EQ(tls_allocation_count, before);
+  }
+}
+
+// Validate that tasks fanned out from worker threads all run in
+// work-stealing mode, including when one worker produces all of them.
+TEST(ThreadPoolTest, WorkStealingRunsNestedTasks)
+{
+  constexpr int kFanOut = 64;
+  constexpr int kRoots = 16;
+  std::atomic<int> count{0};
+  {
+    tc::ThreadPool::Options options;
+    options.thread_count = 4;
+    options.work_stealing = true;
+    tc::ThreadPool pool(options);
+    EXPECT_EQ(pool.Size(), 4u);
+    for (int r = 0; r < kRoots; ++r) {
+      pool.Enqueue([&pool, &count]() {
+        for (int i = 0; i < kFanOut; ++i) {
+          pool.Enqueue([&count]() { count++; });
+        }
+      });
+    }
+    while (count < kRoots * kFanOut) {
+      std::this_thread::yield();
+    }
+  }
+  EXPECT_EQ(count, kRoots * kFanOut);
+}
+
+// Validate that tasks waiting in a worker's deque are reported by
+// TaskQueueSize() and can be stolen by idle peers.
+TEST(ThreadPoolTest, WorkStealingQueueSizeIncludesDeques)
+{
+  tc::ThreadPool::Options options;
+  options.thread_count = 2;
+  options.work_stealing = true;
+  tc::ThreadPool pool(options);
+
+  std::atomic<bool> release{false};
+  std::atomic<bool> blocked{false};
+  std::atomic<bool> pushed{false};
+  std::atomic<int> count{0};
+  // Occupy both workers so the nested tasks stay queued.
+  pool.Enqueue([&]() {
+    blocked = true;
+    while (!release) {
+      std::this_thread::yield();
+    }
+  });
+  while (!blocked) {
+    std::this_thread::yield();
+  }
+  pool.Enqueue([&]() {
+    for (int i = 0; i < 8; ++i) {
+      pool.Enqueue([&count]() { count++; });
+    }
+    pushed = true;
+    while (!release) {
+      std::this_thread::yield();
+    }
+  });
+  while (!pushed) {
+    std::this_thread::yield();
+  }
+  EXPECT_EQ(pool.TaskQueueSize(), 8u);
+
+  release = true;
+  while (count < 8) {
+    std::this_thread::yield();
+  }
+  EXPECT_EQ(pool.TaskQueueSize(), 0u);
+}
+
+// Validate that an elastic pool spawns workers when tasks queue up and
+// retires them after the keepalive.
+TEST(ThreadPoolTest, ElasticPoolGrowsAndShrinks)
+{
+  tc::ThreadPool::Options options;
+  options.thread_count = 1;
+  options.max_thread_count = 3;
+  options.keepalive = std::chrono::milliseconds(20);
+  tc::ThreadPool pool(options);
+  EXPECT_EQ(pool.Size(), 1u);
+
+  std::atomic<bool> released{false};
+  std::atomic<int> running{0};
+  for (int i = 0; i < 5; ++i) {
+    pool.Enqueue([&]() {
+      running++;
+      while (!released) {
+        std::this_thread::yield();
+      }
+    });
+  }
+  while (running != 3) {
+    std::this_thread::yield();
+  }
+  // Never beyond the maximum
+  EXPECT_EQ(pool.Size(), 3u);
+  EXPECT_EQ(pool.GetResizeCounters().grow_count, 2u);
+
+  released = true;
+  while (pool.Size() != 1) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  EXPECT_EQ(running, 5);
+  EXPECT_EQ(pool.GetResizeCounters().shrink_count, 2u);
+}
+
+// Validate that an elastic pool spawns a worker when a task waits for
+// longer than the wait time threshold.
+TEST(ThreadPoolTest, ElasticPoolGrowsOnWaitTime)
+{
+  tc::ThreadPool::Options options;
+  options.thread_count = 1;
+  options.max_thread_count = 2;
+  options.grow_queue_depth = 100;
+  options.grow_wait_time = std::chrono::milliseconds(1);
+  tc::ThreadPool pool(options);
+
+  WorkerGate gate(pool);
+  pool.Enqueue([]() {});
+  EXPECT_EQ(pool.Size(), 1u);
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  pool.Enqueue([]() {});
+  EXPECT_EQ(pool.Size(), 2u);
+  EXPECT_EQ(pool.GetResizeCounters().grow_count, 1u);
+  gate.Release();
+}
+
+TEST(ThreadPoolTest, InvalidElasticOptionsThrow)
+{
+  tc::ThreadPool::Options options;
+  options.thread_count = 2;
+  options.max_thread_count = 1;
+  EXPECT_THROW(tc::ThreadPool pool(options), std::invalid_argument);
+  options.max_thread_count = 4;
+  options.work_stealing = true;
+  EXPECT_THROW(tc::ThreadPool pool(options), std::invalid_argument);
+}
+
+// Validate that the metrics account for every task, the time it waited in
+// the queue and the time it ran.
+TEST(ThreadPoolTest, CollectsMetrics)
+{
+  for (const bool work_stealing : {false, true}) {
+    tc::ThreadPool::Options options;
+    options.thread_count = 2;
+    options.work_stealing = work_stealing;
+    options.enable_metrics = true;
+    tc::ThreadPool pool(options);
+
+    WorkerGate gate(pool);
+    for (int i = 0; i < 10; ++i) {
+      pool.Enqueue([]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+      });
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    gate.Release();
+    std::vector<tc::TaskFuture<void>> done;
+    for (int i = 0; i < 2; ++i) {
+      done.emplace_back(pool.Submit([]() {}));
+    }
+    for (auto& future : done) {
+      future.Get();
+    }
+    // The futures are ready just before their tasks are recorded
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+    const tc::ThreadPool::Metrics metrics = pool.GetMetrics();
+    EXPECT_EQ(metrics.tasks_enqueued, 13u);
+    EXPECT_EQ(metrics.tasks_completed, 13u);
+    EXPECT_EQ(metrics.queue_depth, 0u);
+    if (!work_stealing) {
+      EXPECT_GE(metrics.peak_queue_depth, 9u);
+    }
+    EXPECT_GE(metrics.total_run_time, std::chrono::milliseconds(25));
+    EXPECT_GE(metrics.total_queue_wait, std::chrono::milliseconds(20));
+    uint64_t wait_count = 0;
+    uint64_t run_count = 0;
+    for (size_t i = 0; i < tc::ThreadPool::kHistogramBuckets; ++i) {
+      wait_count += metrics.queue_wait_histogram[i];
+      run_count += metrics.run_time_histogram[i];
+    }
+    EXPECT_EQ(wait_count, 13u);
+    EXPECT_EQ(run_count, 13u);
+    // 2 ms tasks are in the [1024, 2048) or [2048, 4096) us buckets
+    EXPECT_GE(
+        metrics.run_time_histogram[11] + metrics.run_time_histogram[12] +
+            metrics.run_time_histogram[13],
+        10u);
+
+    ASSERT_EQ(metrics.workers.size(), 2u);
+    uint64_t worker_tasks = 0;
+    for (const auto& worker : metrics.workers) {
+      worker_tasks += worker.tasks_completed;
+      EXPECT_GE(worker.busy_ratio, 0.0);
+      EXPECT_LE(worker.busy_ratio, 1.0);
+    }
+    EXPECT_EQ(worker_tasks, 13u);
+
+    const std::string table = tc::ThreadPoolMetricsTable(metrics);
+    EXPECT_NE(table.find("Tasks completed"), std::string::npos);
+    EXPECT_NE(table.find("Busy %"), std::string::npos);
+  }
+}
+
+// Validate that only the queue depths are collected by default.
+TEST(ThreadPoolTest, MetricsDisabledByDefault)
+{
+  tc::ThreadPool pool(1);
+  WorkerGate gate(pool);
+  pool.Enqueue([]() {});
+  pool.Enqueue([]() {});
+  EXPECT_EQ(pool.GetMetrics().queue_depth, 2u);
+  gate.Release();
+  const tc::ThreadPool::Metrics metrics = pool.GetMetrics();
+  EXPECT_EQ(metrics.peak_queue_depth, 2u);
+  EXPECT_EQ(metrics.tasks_completed, 0u);
+  EXPECT_TRUE(metrics.workers.empty());
+}
+
+TEST(ThreadPoolMetricsTest, HistogramQuantile)
+{
+  std::array<uint64_t, tc::ThreadPool::kHistogramBuckets> histogram{};
+  EXPECT_EQ(tc::ThreadPoolHistogramQuantile(histogram, 0.5), 0u);
+  histogram[0] = 90;
+  histogram[4] = 10;
+  EXPECT_EQ(tc::ThreadPoolHistogramQuantile(histogram, 0.5), 1u);
+  EXPECT_EQ(tc::ThreadPoolHistogramQuantile(histogram, 0.99), 16u);
+}
+
+// Validate that Drain() waits for the queued and running tasks, up to its
+// deadline.
+TEST(ThreadPoolTest, DrainWaitsForTasks)
+{
+  for (const bool work_stealing : {false, true}) {
+    tc::ThreadPool::Options options;
+    options.thread_count = 2;
+    options.work_stealing = work_stealing;
+    tc::ThreadPool pool(options);
+
+    std::atomic<int> count{0};
+    {
+      WorkerGate gate(pool);
+      for (int i = 0; i < 20; ++i) {
+        EXPECT_TRUE(pool.Enqueue([&count]() { count++; }));
+      }
+      EXPECT_FALSE(pool.Drain(
+          std::chrono::steady_clock::now() + std::chrono::milliseconds(10)));
+    }
+    EXPECT_TRUE(pool.Drain());
+    EXPECT_EQ(count, 20);
+    EXPECT_EQ(pool.TaskQueueSize(), 0u);
+
+    // The pool keeps accepting tasks after draining
+    EXPECT_TRUE(pool.Enqueue([&count]() { count++; }));
+    EXPECT_TRUE(pool.Drain());
+    EXPECT_EQ(count, 21);
+  }
+}
+
+// Validate that a shut down pool rejects tasks and breaks the futures of
+// rejected Submit() calls.
+TEST(ThreadPoolTest, RejectsTasksAfterShutdown)
+{
+  tc::ThreadPool pool(2);
+  std::atomic<int> count{0};
+  for (int i = 0; i < 10; ++i) {
+    pool.Enqueue([&count]() { count++; });
+  }
+  EXPECT_EQ(pool.Shutdown(), 0u);
+  EXPECT_EQ(count, 10);
+  EXPECT_EQ(pool.Size(), 0u);
+
+  EXPECT_FALSE(pool.Enqueue([&count]() { count++; }));
+  auto future = pool.Submit([]() { return 1; });
+  EXPECT_THROW(future.Get(), std::future_error);
+  // Shutting down again is a no-op
+  EXPECT_EQ(pool.Shutdown(), 0u);
+  EXPECT_EQ(count, 10);
+}
+
+// Validate that discarding shutdown drops the tasks that have not started,
+// in both scheduling modes.
+TEST(ThreadPoolTest, ShutdownDiscardsRemainingTasks)
+{
+  for (const bool work_stealing : {false, true}) {
+    tc::ThreadPool::Options options;
+    options.thread_count = 1;
+    options.work_stealing = work_stealing;
+    tc::ThreadPool pool(options);
+
+    std::atomic<int> count{0};
+    std::atomic<bool> started{false};
+    std::atomic<bool> released{false};
+    pool.Enqueue([&]() {
+      // Fan out to the worker's own deque in work-stealing mode
+      for (int i = 0; i < 5; ++i) {
+        pool.Enqueue([&count]() { count++; });
+      }
+      started = true;
+      while (!released) {
+        std::this_thread::yield();
+      }
+    });
+    for (int i = 0; i < 5; ++i) {
+      pool.Enqueue([&count]() { count++; });
+    }
+    auto future = pool.Submit([]() { return 1; });
+    while (!started) {
+      std::this_thread::yield();
+    }
+
+    size_t discarded = 0;
+    std::thread shutdown([&]() {
+      discarded =
+          pool.Shutdown(tc::ThreadPool::ShutdownMode::kDISCARD_REMAINING);
+    });
+    // Probe until the shutdown has started, the accepted probes are
+    // discarded as well
+    size_t probes = 0;
+    while (pool.Enqueue([&count]() { count++; })) {
+      ++probes;
+      std::this_thread::yield();
+    }
+    released = true;
+    shutdown.join();
+
+    EXPECT_EQ(count, 0);
+    EXPECT_EQ(discarded, 11u + probes);
+    EXPECT_THROW(future.Get(), std::future_error);
+  }
+}
+
+// Validate that cancelled tasks are skipped if they have not started.
+TEST(ThreadPoolTest, CancelledTasksDoNotRun)
+{
+  tc::ThreadPool pool(1);
+  tc::CancellationToken token;
+  std::atomic<int> cancellable{0};
+  std::atomic<int> other{0};
+  {
+    WorkerGate gate(pool);
+    for (int i = 0; i < 3; ++i) {
+      EXPECT_TRUE(pool.Enqueue([&cancellable]() { cancellable++; }, token));
+    }
+    pool.Enqueue([&other]() { other++; });
+    token.Cancel();
+    EXPECT_TRUE(token.IsCancelled());
+  }
+  EXPECT_TRUE(pool.Drain());
+  EXPECT_EQ(cancellable, 0);
+  EXPECT_EQ(other, 1);
+}
+
+// Validate that tasks of one key run in order and never overlap while
+// different keys run in parallel.
+TEST(StrandExecutorTest, RunsTasksOfAKeyInOrder)
+{
+  constexpr int kKeys = 8;
+  constexpr int kTasksPerKey = 200;
+  tc::ThreadPool pool(4);
+  std::array<std::vector<int>, kKeys> order;
+  std::array<std::atomic<int>, kKeys> running{};
+  std::atomic<bool> overlapped{false};
+  {
+    tc::StrandExecutor<int> strands(&pool, 16 /* max_tasks_per_run */);
+    std::vector<std::thread> producers;
+    for (int key = 0; key < kKeys; ++key) {
+      producers.emplace_back([&, key]() {
+        for (int i = 0; i < kTasksPerKey; ++i) {
+          EXPECT_TRUE(strands.Post(key, [&, key, i]() {
+            if (running[key]++ != 0) {
+              overlapped = true;
+            }
+            order[key].push_back(i);
+            running[key]--;
+          }));
+        }
+      });
+    }
+    for (auto& producer : producers) {
+      producer.join();
+    }
+  }
+  EXPECT_FALSE(overlapped);
+  for (int key = 0; key < kKeys; ++key) {
+    ASSERT_EQ(order[key].size(), size_t(kTasksPerKey));
+    for (int i = 0; i < kTasksPerKey; ++i) {
+      EXPECT_EQ(order[key][i], i);
+    }
+  }
+}
+
+// Validate that a busy key does not hold back other keys and that idle
+// keys are released.
+TEST(StrandExecutorTest, KeysDoNotBlockEachOther)
+{
+  tc::ThreadPool pool(2);
+  tc::StrandExecutor<std::string> strands(&pool);
+  std::promise<void> release;
+  std::shared_future<void> released = release.get_future().share();
+  std::atomic<int> blocked_key_done{0};
+  EXPECT_TRUE(strands.Post("blocked", [released]() { released.wait(); }));
+  EXPECT_TRUE(
+      strands.Post("blocked", [&blocked_key_done]() { blocked_key_done++; }));
+  std::promise<void> other_done;
+  EXPECT_TRUE(
+      strands.Post("other", [&other_done]() { other_done.set_value(); }));
+  other_done.get_future().wait();
+  EXPECT_EQ(blocked_key_done, 0);
+  release.set_value();
+  ASSERT_TRUE(pool.Drain());
+  EXPECT_EQ(blocked_key_done, 1);
+  EXPECT_EQ(strands.ActiveStrands(), 0u);
+}
+
+// Validate that an executor can be destroyed as soon as its last task
+// finishes, while the drain is still accounting for it.
+TEST(StrandExecutorTest, DestroyedRightAfterPost)
+{
+  tc::ThreadPool pool(2);
+  std::atomic<int> ran{0};
+  for (int i = 0; i < 1000; ++i) {
+    std::unique_ptr<tc::StrandExecutor<int>> strands(
+        new tc::StrandExecutor<int>(&pool));
+    EXPECT_TRUE(strands->Post(i, [&ran]() { ran++; }));
+    strands.reset();
+  }
+  EXPECT_EQ(ran, 1000);
+}
+
+// Validate that tasks are rejected, not leaked, once the pool is shut down.
+TEST(StrandExecutorTest, RejectsTasksAfterShutdown)
+{
+  tc::ThreadPool pool(1);
+  tc::StrandExecutor<int> strands(&pool);
+  pool.Shutdown();
+  std::atomic<int> ran{0};
+  EXPECT_FALSE(strands.Post(1, [&ran]() { ran++; }));
+  EXPECT_EQ(ran, 0);
+  EXPECT_EQ(strands.ActiveStrands(), 0u);
+}
+
+// Validate that timers fire no earlier than their deadline and in
+// deadline order, including timers cascading down from upper levels.
+TEST(TimerWheelTest, RunsTasksAtDeadline)
+{
+  tc::ThreadPool pool(1);
+  // 64, 64^2 and 64^3 ticks of 10us are 0.64ms, 41ms and 2.6s
+  tc::TimerWheel timers(&pool, std::chrono::microseconds(10));
+  const std::vector<std::chrono::microseconds> delays{
+      std::chrono::microseconds(50000), std::chrono::microseconds(300),
+      std::chrono::microseconds(5000), std::chrono::microseconds(0)};
+  const auto start = tc::TimerWheel::Clock::now();
+  std::mutex mu;
+  std::vector<size_t> order;
+  std::atomic<bool> early{false};
+  for (size_t i = 0; i < delays.size(); ++i) {
+    EXPECT_NE(
+        timers.ScheduleAfter(
+            delays[i],
+            [&, i]() {
+              if (tc::TimerWheel::Clock::now() < start + delays[i]) {
+                early = true;
+              }
+              std::lock_guard<std::mutex> lk(mu);
+              order.push_back(i);
+            }),
+        0u);
+  }
+  while (true) {
+    {
+      std::lock_guard<std::mutex> lk(mu);
+      if (order.size() == delays.size()) {
+        break;
+      }
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_EQ(timers.PendingCount(), 0u);
+  EXPECT_FALSE(early);
+  EXPECT_EQ(order, (std::vector<size_t>{3, 1, 2, 0}));
+}
+
+// Validate that cancelled timers never run and that IDs are not reused.
+TEST(TimerWheelTest, CancelledTimersDoNotRun)
+{
+  tc::ThreadPool pool(1);
+  tc::TimerWheel timers(&pool);
+  std::atomic<int> ran{0};
+  const tc::TimerWheel::TimerId cancelled =
+      timers.ScheduleAfter(std::chrono::milliseconds(5), [&ran]() { ran++; });
+  std::promise<void> done;
+  const tc::TimerWheel::TimerId kept = timers.ScheduleAfter(
+      std::chrono::milliseconds(10), [&done]() { done.set_value(); });
+  EXPECT_TRUE(timers.Cancel(cancelled));
+  EXPECT_FALSE(timers.Cancel(cancelled));
+  done.get_future().wait();
+  EXPECT_FALSE(timers.Cancel(kept));
+
+  // The freed timer is reused under a different ID
+  const tc::TimerWheel::TimerId reused =
+      timers.ScheduleAfter(std::chrono::hours(1), [&ran]() { ran++; });
+  EXPECT_NE(reused, cancelled);
+  EXPECT_FALSE(timers.Cancel(cancelled));
+  EXPECT_TRUE(timers.Cancel(reused));
+  ASSERT_TRUE(pool.Drain());
+  EXPECT_EQ(ran, 0);
+}
+
+// Validate that many pending timers are handled by the one timer thread.
+TEST(TimerWheelTest, HandlesManyTimers)
+{
+  constexpr size_t kTimers = 200000;
+  tc::ThreadPool pool(2);
+  tc::TimerWheel timers(&pool);
+  std::atomic<size_t> ran{0};
+  std::vector<tc::TimerWheel::TimerId> ids;
+  ids.reserve(kTimers);
+  for (size_t i = 0; i < kTimers; ++i) {
+    // Every other timer is far out and cancelled below
+    const std::chrono::microseconds delay =
+        (i % 2 == 0) ? std::chrono::microseconds(std::chrono::hours(1))
+                     : std::chrono::microseconds(1000 + (i % 100) * 100);
+    ids.push_back(timers.ScheduleAfter(delay, [&ran]() { ran++; }));
+  }
+  size_t cancelled = 0;
+  for (size_t i = 0; i < kTimers; i += 2) {
+    cancelled += timers.Cancel(ids[i]) ? 1 : 0;
+  }
+  EXPECT_EQ(cancelled, kTimers / 2);
+  while (ran + cancelled != kTimers) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_EQ(timers.PendingCount(), 0u);
+}
+
+// Validate that every index is visited exactly once, with the caller
+// participating, and that reductions combine all chunks.
+TEST(ParallelForTest, CoversRangeOnce)
+{
+  tc::ThreadPool pool(3);
+  constexpr int kCount = 100000;
+  std::vector<std::atomic<int>> visits(kCount);
+  std::atomic<int> chunks{0};
+  const std::thread::id caller = std::this_thread::get_id();
+  tc::ParallelFor(&pool, 0, kCount, 64, [&](int chunk_begin, int chunk_end) {
+    EXPECT_GE(chunk_end - chunk_begin, 1);
+    chunks++;
+    for (int i = chunk_begin; i < chunk_end; ++i) {
+      visits[i]++;
+    }
+  });
+  for (int i = 0; i < kCount; ++i) {
+    ASSERT_EQ(visits[i], 1) << "index " << i;
+  }
+  // Guided chunk sizes need far fewer chunks than the grain alone
+  EXPECT_LT(chunks, kCount / 64);
+
+  const int64_t sum = tc::ParallelReduce(
+      &pool, int64_t(1), int64_t(kCount + 1), int64_t(100), int64_t(0),
+      [](int64_t chunk_begin, int64_t chunk_end) {
+        int64_t partial = 0;
+        for (int64_t i = chunk_begin; i < chunk_end; ++i) {
+          partial += i;
+        }
+        return partial;
+      },
+      [](int64_t lhs, int64_t rhs) { return lhs + rhs; });
+  EXPECT_EQ(sum, int64_t(kCount) * (kCount + 1) / 2);
+
+  // Empty ranges and ranges of a single chunk run on the caller
+  EXPECT_EQ(
+      tc::ParallelReduce(
+          &pool, 5, 5, 1, 7, [](int, int) { return 1; },
+          [](int lhs, int rhs) { return lhs + rhs; }),
+      7);
+  tc::ParallelFor(&pool, 0, 10, 10, [&](int, int) {
+    EXPECT_EQ(std::this_thread::get_id(), caller);
+  });
+}
+
+// Validate that the caller runs all chunks when the pool is busy.
+TEST(ParallelForTest, CallerRunsChunksOfBusyPool)
+{
+  tc::ThreadPool pool(1);
+  WorkerGate gate(pool);
+  const std::thread::id caller = std::this_thread::get_id();
+  std::atomic<int> visited{0};
+  tc::ParallelFor(&pool, 0, 1000, 10, [&](int chunk_begin, int chunk_end) {
+    EXPECT_EQ(std::this_thread::get_id(), caller);
+    visited += chunk_end - chunk_begin;
+  });
+  EXPECT_EQ(visited, 1000);
+}
+
+// Validate that nested calls from pool workers complete and that an
+// exception stops the loop and is rethrown to the caller.
+TEST(ParallelForTest, NestedCallsAndExceptions)
+{
+  tc::ThreadPool pool(2);
+  std::atomic<int> total{0};
+  tc::ParallelFor(&pool, 0, 8, 1, [&](int outer_begin, int outer_end) {
+    for (int outer = outer_begin; outer < outer_end; ++outer) {
+      tc::ParallelFor(&pool, 0, 100, 10, [&](int chunk_begin, int chunk_end) {
+        total += chunk_end - chunk_begin;
+      });
+    }
+  });
+  EXPECT_EQ(total, 800);
+
+  std::atomic<int> visited{0};
+  EXPECT_THROW(
+      tc::ParallelFor(
+          &pool, 0, 100000, 1,
+          [&](int chunk_begin, int chunk_end) {
+            visited += chunk_end - chunk_begin;
+            throw std::runtime_error("chunk failed");
+          }),
+      std::runtime_error);
+  EXPECT_LT(visited, 100000);
+  ASSERT_TRUE(pool.Drain());
+}
+
+#ifdef TRITON_COMMON_ENABLE_COROUTINES
+tc::Task<std::thread::id>
+ScheduledThread(tc::ThreadPool* pool)
+{
+  const bool scheduled = co_await tc::Schedule(*pool);
+  EXPECT_TRUE(scheduled);
+  co_return std::this_thread::get_id();
+}
+
+tc::Task<int>
+SumOnPool(tc::ThreadPool* pool, int count)
+{
+  int sum = 0;
+  for (int i = 0; i < count; ++i) {
+    co_await tc::Schedule(*pool);
+    sum += i;
+  }
+  co_return sum;
+}
+
+tc::Task<void>
+Throws(tc::ThreadPool* pool)
+{
+  co_await tc::Schedule(*pool);
+  throw std::runtime_error("stage failed");
+}
+
+// Validate that coroutines hop onto pool workers, compose and propagate
+// exceptions.
+TEST(CoroutineTest, ResumesOnPoolWorkers)
+{
+  tc::ThreadPool pool(2);
+  EXPECT_NE(ScheduledThread(&pool).Get(), std::this_thread::get_id());
+  EXPECT_EQ(SumOnPool(&pool, 100).Get(), 4950);
+
+  auto outer = [](tc::ThreadPool* pool) -> tc::Task<int> {
+    const int first = co_await SumOnPool(pool, 10);
+    const int second = co_await SumOnPool(pool, 5);
+    co_return first + second;
+  };
+  EXPECT_EQ(outer(&pool).Get(), 55);
+  EXPECT_THROW(Throws(&pool).Get(), std::runtime_error);
+}
+
+// Validate that a coroutine resumes on the caller if the pool is shut down.
+TEST(CoroutineTest, ScheduleOnShutDownPool)
+{
+  tc::ThreadPool pool(1);
+  pool.Shutdown();
+  auto task = [](tc::ThreadPool* pool) -> tc::Task<bool> {
+    co_return co_await tc::Schedule(*pool);
+  };
+  EXPECT_FALSE(task(&pool).Get());
+}
+
+// Validate that awaiting a SyncQueue get suspends instead of blocking and
+// resumes on the pool once an item is put.
+TEST(CoroutineTest, AwaitsSyncQueueGet)
+{
+  tc::ThreadPool pool(1);
+  tc::SyncQueue<int> queue;
+  std::atomic<int> received{0};
+  auto consumer = [&](int count) -> tc::Task<void> {
+    for (int i = 0; i < count; ++i) {
+      const std::optional<int> item = co_await tc::AsyncGet(&queue, &pool);
+      EXPECT_TRUE(item.has_value());
+      received += item.value_or(0);
+    }
+    // Gets of a closed and drained queue return no item
+    EXPECT_FALSE((co_await tc::AsyncGet(&queue, &pool)).has_value());
+  };
+  std::thread waiter([&]() { consumer(3).Get(); });
+  queue.Put(1);
+  queue.Put(2);
+  queue.Put(3);
+  queue.Close();
+  waiter.join();
+  EXPECT_EQ(received, 6);
+}
+
+// Validate that coroutine frames are recycled.
+TEST(CoroutineTest, RecyclesFrames)
+{
+  tc::ThreadPool pool(1);
+  EXPECT_EQ(SumOnPool(&pool, 1).Get(), 0);
+  const size_t before = tls_allocation_count;
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(SumOnPool(&pool, 1).Get(), 0);
+  }
+  // The frames are reused, only each Get() allocates its wait state
+  EXPECT_LE(tls_allocation_count - before, 100u);
+}
+#endif  // TRITON_COMMON_ENABLE_COROUTINES
+
+#ifdef __linux__
+// Returns the CPUs the calling thread may run on.
+std::vector<int>
+ThreadCpus()
+{
+  std::vector<int> cpus;
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+      if (CPU_ISSET(cpu, &set)) {
+        cpus.push_back(cpu);
+      }
+    }
+  }
+  return cpus;
+}
+
+// Validate that workers are pinned to the requested CPU and named.
+TEST(ThreadPoolTest, PinsAndNamesWorkers)
+{
+  const std::vector<int> allowed = ThreadCpus();
+  ASSERT_FALSE(allowed.empty());
+
+  tc::ThreadPool::Options options;
+  options.thread_count = 2;
+  options.cpus = {allowed.back()};
+  options.thread_name = "tp-test-worker-";
+  tc::ThreadPool pool(options);
+
+  auto cpus = pool.Submit(ThreadCpus);
+  auto name = pool.Submit([]() {
+    char buf[16] = {};
+    pthread_getname_np(pthread_self(), buf, sizeof(buf));
+    return std::string(buf);
+  });
+  EXPECT_EQ(cpus.Get(), std::vector<int>{allowed.back()});
+  const std::string worker_name = name.Get();
+  EXPECT_EQ(worker_name.size(), 15u);
+  EXPECT_EQ(worker_name.rfind("tp-test-worker-", 0), 0u);
+}
+
+TEST(ThreadPoolTest, InvalidAffinityOptionsThrow)
+{
+  tc::ThreadPool::Options options;
+  options.cpus = {-1};
+  EXPECT_THROW(tc::ThreadPool pool(options), std::invalid_argument);
+  options.cpus = {ThreadCpus().front()};
+  options.numa_nodes = {0};
+  EXPECT_THROW(tc::ThreadPool pool(options), std::invalid_argument);
+  options.cpus.clear();
+  options.numa_nodes = {0, 1 << 20};
+  options.thread_count = 2;
+  EXPECT_THROW(tc::ThreadPool pool(options), std::invalid_argument);
+}
+
+// Validate that the workers of a NUMA node sub-pool run on that node, and
+// that tasks enqueued by a worker stay on its node.
+TEST(ThreadPoolTest, NumaNodeSubPools)
+{
+  std::ifstream cpulist("/sys/devices/system/node/node0/cpulist");
+  if (!cpulist) {
+    GTEST_SKIP() << "NUMA topology is not available";
+  }
+  std::string list;
+  std::getline(cpulist, list);
+
+  tc::ThreadPool::Options options;
+  options.thread_count = 2;
+  options.numa_nodes = {0};
+  tc::ThreadPool pool(options);
+  EXPECT_EQ(pool.Size(), 2u);
+
+  std::atomic<bool> nested_done{false};
+  std::vector<int> nested_cpus;
+  auto cpus = pool.Submit([&]() {
+    pool.Enqueue([&]() {
+      nested_cpus = ThreadCpus();
+      nested_done = true;
+    });
+    return ThreadCpus();
+  });
+  const std::vector<int> worker_cpus = cpus.Get();
+  while (!nested_done) {
+    std::this_thread::yield();
+  }
+  ASSERT_EQ(worker_cpus.size(), 1u);
+  EXPECT_EQ(nested_cpus.size(), 1u);
+
+  // The worker's CPU is listed in the node's CPU list, e.g. "0-3,8-11"
+  bool on_node = false;
+  std::stringstream ss(list);
+  std::string range;
+  while (std::getline(ss, range, ',')) {
+    const size_t dash = range.find('-');
+    const int first = std::stoi(range.substr(0, dash));
+    const int last = (dash == std::string::npos)
+                         ? first
+                         : std::stoi(range.substr(dash + 1));
+    on_node |= (worker_cpus[0] >= first) && (worker_cpus[0] <= last);
+  }
+  EXPECT_TRUE(on_node);
+}
+#endif  // __linux__
+
+}  // namespace
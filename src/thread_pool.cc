@@ -1,4 +1,4 @@
-// Copyright 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+// Copyright 2022-2026, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 //
 // Redistribution and use in source and binary forms, with or without
 // modification, are permitted provided that the following conditions
@@ -26,73 +26,1088 @@
 
 #include "triton/common/thread_pool.h"
 
+#include <algorithm>
+#include <fstream>
+#include <sstream>
 #include <stdexcept>
 
+#include "triton/common/work_stealing_deque.h"
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 namespace triton { namespace common {
 
+namespace {
+
+// The pool and worker index of the calling thread, if it is a work-stealing
+// worker. Used to route tasks enqueued by a worker to its own deque.
+thread_local ThreadPool* tls_pool = nullptr;
+thread_local size_t tls_worker_index = 0;
+
+uint32_t
+NextRandom(uint32_t* seed)
+{
+  // xorshift32, only used to pick a steal victim
+  uint32_t x = *seed;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  *seed = x;
+  return x;
+}
+
+ThreadPool::Options
+DefaultOptions(size_t thread_count)
+{
+  ThreadPool::Options options;
+  options.thread_count = thread_count;
+  return options;
+}
+
+#ifdef __linux__
+// Returns the sorted list of CPUs the calling thread may run on.
+std::vector<int>
+AllowedCpus()
+{
+  std::vector<int> cpus;
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+      if (CPU_ISSET(cpu, &set)) {
+        cpus.push_back(cpu);
+      }
+    }
+  }
+  return cpus;
+}
+
+// Returns the CPUs of NUMA 'node', parsed from its sysfs CPU list, e.g.
+// "0-3,8-11".
+std::vector<int>
+NumaNodeCpus(int node)
+{
+  std::ifstream file(
+      "/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+  std::string list;
+  if (!std::getline(file, list)) {
+    throw std::invalid_argument(
+        "Failed to read the CPUs of NUMA node " + std::to_string(node) + ".");
+  }
+  std::vector<int> cpus;
+  std::stringstream ss(list);
+  std::string range;
+  while (std::getline(ss, range, ',')) {
+    if (range.empty()) {
+      continue;
+    }
+    const size_t dash = range.find('-');
+    const int first = std::stoi(range.substr(0, dash));
+    const int last = (dash == std::string::npos)
+                         ? first
+                         : std::stoi(range.substr(dash + 1));
+    for (int cpu = first; cpu <= last; ++cpu) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+#endif  // __linux__
+
+// Adds 'value' to a counter that has a single writer, avoiding the cost
+// of an atomic read-modify-write.
+void
+AddRelaxed(std::atomic<uint64_t>& counter, uint64_t value)
+{
+  counter.store(
+      counter.load(std::memory_order_relaxed) + value,
+      std::memory_order_relaxed);
+}
+
+uint64_t
+ToNanoseconds(std::chrono::steady_clock::duration duration)
+{
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+}
+
+// Returns the latency histogram bucket of a duration of 'ns' nanoseconds.
+size_t
+HistogramBucket(uint64_t ns)
+{
+  uint64_t us = ns / 1000;
+  size_t bucket = 0;
+  while ((us != 0) && (bucket < (ThreadPool::kHistogramBuckets - 1))) {
+    us >>= 1;
+    ++bucket;
+  }
+  return bucket;
+}
+
+}  // namespace
+
+struct ThreadPool::QueuedTask {
+  Task task_;
+  std::chrono::steady_clock::time_point enqueue_time_;
+  // Cancellation flag of the task's token, if any
+  std::shared_ptr<std::atomic<bool>> cancelled_;
+};
+
+// Metrics of one worker slot. Each counter is only written by the worker
+// running in the slot, with relaxed stores, and read by GetMetrics().
+struct alignas(64) ThreadPool::WorkerStats {
+  void Record(
+      std::chrono::steady_clock::duration wait,
+      std::chrono::steady_clock::duration run)
+  {
+    const uint64_t wait_ns = ToNanoseconds(wait);
+    const uint64_t run_ns = ToNanoseconds(run);
+    AddRelaxed(tasks_completed_, 1);
+    AddRelaxed(wait_ns_, wait_ns);
+    AddRelaxed(busy_ns_, run_ns);
+    AddRelaxed(wait_histogram_[HistogramBucket(wait_ns)], 1);
+    AddRelaxed(run_histogram_[HistogramBucket(run_ns)], 1);
+  }
+
+  std::atomic<uint64_t> tasks_completed_{0};
+  std::atomic<uint64_t> wait_ns_{0};
+  std::atomic<uint64_t> busy_ns_{0};
+  std::array<std::atomic<uint64_t>, kHistogramBuckets> wait_histogram_{};
+  std::array<std::atomic<uint64_t>, kHistogramBuckets> run_histogram_{};
+};
+
+struct ThreadPool::Worker {
+  explicit Worker(FreeList& task_blocks) : task_blocks_(task_blocks) {}
+
+  ~Worker()
+  {
+    QueuedTask task;
+    while (Pop(&task)) {
+    }
+  }
+
+  // Push 'task' to the deque, must be called by the owning worker.
+  void Push(QueuedTask&& task)
+  {
+    deque_.Push(::new (task_blocks_.Allocate()) QueuedTask(std::move(task)));
+  }
+
+  // Pop from the deque, must be called by the owning worker.
+  bool Pop(QueuedTask* task)
+  {
+    QueuedTask* node;
+    if (!deque_.Pop(&node)) {
+      return false;
+    }
+    Take(node, task);
+    return true;
+  }
+
+  // Steal from the deque, may be called by any worker.
+  bool Steal(QueuedTask* task)
+  {
+    QueuedTask* node;
+    if (!deque_.Steal(&node)) {
+      return false;
+    }
+    Take(node, task);
+    return true;
+  }
+
+  void Take(QueuedTask* node, QueuedTask* task)
+  {
+    *task = std::move(*node);
+    node->~QueuedTask();
+    task_blocks_.Deallocate(node);
+  }
+
+  FreeList& task_blocks_;
+  WorkStealingDeque<QueuedTask*> deque_;
+};
+
+// Growable circular FIFO of tasks. Unlike std::queue, the storage is kept
+// when the queue drains so a pool in steady state does not allocate.
+class ThreadPool::TaskRing {
+ public:
+  bool empty() const { return size_ == 0; }
+  size_t size() const { return size_; }
+
+  QueuedTask& front() { return slots_[head_]; }
+
+  void push(QueuedTask&& task)
+  {
+    if (size_ == slots_.size()) {
+      Grow();
+    }
+    slots_[(head_ + size_) & (slots_.size() - 1)] = std::move(task);
+    ++size_;
+  }
+
+  void pop()
+  {
+    slots_[head_].task_.Reset();
+    head_ = (head_ + 1) & (slots_.size() - 1);
+    --size_;
+  }
+
+ private:
+  void Grow()
+  {
+    std::vector<QueuedTask> grown(slots_.empty() ? 64 : slots_.size() * 2);
+    for (size_t i = 0; i < size_; ++i) {
+      grown[i] = std::move(slots_[(head_ + i) & (slots_.size() - 1)]);
+    }
+    slots_.swap(grown);
+    head_ = 0;
+  }
+
+  std::vector<QueuedTask> slots_;
+  size_t head_ = 0;
+  size_t size_ = 0;
+};
+
 ThreadPool::ThreadPool(size_t thread_count)
+    : ThreadPool(DefaultOptions(thread_count))
 {
-  if (!thread_count) {
+}
+
+ThreadPool::ThreadPool(const Options& options)
+    : state_blocks_(std::make_shared<FreeList>(kStateBlockSize)),
+      task_blocks_(sizeof(QueuedTask)),
+      spin_count_(
+          (std::thread::hardware_concurrency() > 1) ? options.spin_count : 0),
+      max_tasks_per_wakeup_(options.max_tasks_per_wakeup),
+      priority_policy_(options.priority_policy),
+      aging_threshold_(options.aging_threshold),
+      record_enqueue_time_(
+          (options.aging_threshold.count() > 0) ||
+          (options.grow_wait_time.count() > 0) || options.enable_metrics),
+      elastic_(options.max_thread_count > options.thread_count),
+      min_thread_count_(options.thread_count),
+      max_thread_count_(std::max(
+          options.thread_count, options.max_thread_count)),
+      grow_queue_depth_(options.grow_queue_depth),
+      grow_wait_time_(options.grow_wait_time), keepalive_(options.keepalive),
+      work_stealing_(options.work_stealing), cpus_(options.cpus),
+      thread_name_(options.thread_name), nice_level_(options.nice_level),
+      start_time_(std::chrono::steady_clock::now())
+{
+  if (!options.thread_count) {
     throw std::invalid_argument("Thread count must be greater than zero.");
   }
+  if (!options.max_tasks_per_wakeup) {
+    throw std::invalid_argument(
+        "Max tasks per wakeup must be greater than zero.");
+  }
 
-  // Define infinite loop for each thread to wait for a task to complete
-  const auto worker_loop = [this]() {
-    while (true) {
-      Task task;
-      {
-        std::unique_lock<std::mutex> lk(queue_mtx_);
-        // Wake if there's a task to do, or the pool has been stopped.
-        cv_.wait(lk, [&]() { return !task_queue_.empty() || stop_; });
-        // Exit condition
-        if (stop_ && task_queue_.empty()) {
-          break;
+  if ((options.max_thread_count != 0) &&
+      (options.max_thread_count < options.thread_count)) {
+    throw std::invalid_argument(
+        "Max thread count must not be less than thread count.");
+  }
+  if (elastic_ && (work_stealing_ || !options.numa_nodes.empty())) {
+    throw std::invalid_argument(
+        "Elastic pools are not supported in work-stealing mode or with NUMA "
+        "nodes.");
+  }
+
+  if (options.priority_levels == 0) {
+    task_queues_.resize(1);
+  } else {
+    if (work_stealing_) {
+      throw std::invalid_argument(
+          "Priority levels are not supported in work-stealing mode.");
+    }
+    if ((options.default_priority_level < 1) ||
+        (options.default_priority_level > options.priority_levels)) {
+      throw std::invalid_argument(
+          "Default priority level must be in [1, priority_levels].");
+    }
+    if (!options.priority_weights.empty() &&
+        (options.priority_weights.size() != options.priority_levels)) {
+      throw std::invalid_argument(
+          "Priority weights must be given for every priority level.");
+    }
+    task_queues_.resize(options.priority_levels);
+    default_level_index_ = options.default_priority_level - 1;
+
+    // Stride is inversely proportional to weight
+    constexpr uint64_t kStrideOne = uint64_t(1) << 20;
+    passes_.resize(options.priority_levels, 0);
+    for (uint32_t i = 0; i < options.priority_levels; ++i) {
+      const uint64_t weight = options.priority_weights.empty()
+                                  ? (options.priority_levels - i)
+                                  : options.priority_weights[i];
+      if (weight == 0) {
+        throw std::invalid_argument(
+            "Priority weights must be greater than zero.");
+      }
+      strides_.push_back(kStrideOne / weight);
+    }
+  }
+
+  if (!options.numa_nodes.empty()) {
+#ifdef __linux__
+    if (!options.cpus.empty()) {
+      throw std::invalid_argument("CPUs and NUMA nodes cannot both be set.");
+    }
+    const size_t node_count = options.numa_nodes.size();
+    if (options.thread_count < node_count) {
+      throw std::invalid_argument(
+          "Thread count must be at least the number of NUMA nodes.");
+    }
+    const std::vector<int> allowed = AllowedCpus();
+    for (size_t i = 0; i < node_count; ++i) {
+      const int node = options.numa_nodes[i];
+      Options node_options = options;
+      node_options.numa_nodes.clear();
+      node_options.thread_count = (options.thread_count / node_count) +
+                                  ((i < options.thread_count % node_count)
+                                       ? 1
+                                       : 0);
+      for (const int cpu : NumaNodeCpus(node)) {
+        if (std::binary_search(allowed.begin(), allowed.end(), cpu)) {
+          node_options.cpus.push_back(cpu);
+        }
+      }
+      if (node_options.cpus.empty()) {
+        throw std::invalid_argument(
+            "NUMA node " + std::to_string(node) +
+            " has no CPU available to the process.");
+      }
+      if (!options.thread_name.empty()) {
+        node_options.thread_name =
+            options.thread_name + std::to_string(node) + "-";
+      }
+      for (const int cpu : node_options.cpus) {
+        if (static_cast<size_t>(cpu) >= cpu_node_pools_.size()) {
+          cpu_node_pools_.resize(cpu + 1, -1);
         }
-        task = std::move(task_queue_.front());
-        task_queue_.pop();
+        cpu_node_pools_[cpu] = static_cast<int>(i);
       }
+      node_pools_.emplace_back(new ThreadPool(node_options));
+    }
+    return;
+#else
+    throw std::invalid_argument("NUMA nodes are only supported on Linux.");
+#endif  // __linux__
+  }
 
-      // Execute task - ensure function has a valid target
-      if (task) {
-        task();
+  if (!options.cpus.empty()) {
+#ifdef __linux__
+    const std::vector<int> allowed = AllowedCpus();
+    for (const int cpu : options.cpus) {
+      if (!std::binary_search(allowed.begin(), allowed.end(), cpu)) {
+        throw std::invalid_argument(
+            "CPU " + std::to_string(cpu) + " is not available to the process.");
       }
     }
-  };
+#else
+    throw std::invalid_argument("CPU affinity is only supported on Linux.");
+#endif  // __linux__
+  }
 
-  workers_.reserve(thread_count);
-  for (size_t i = 0; i < thread_count; ++i) {
-    workers_.emplace_back(worker_loop);
+  if (work_stealing_) {
+    stealing_workers_.reserve(options.thread_count);
+    for (size_t i = 0; i < options.thread_count; ++i) {
+      stealing_workers_.emplace_back(new Worker(task_blocks_));
+    }
+  }
+
+  const size_t slot_count = work_stealing_ ? options.thread_count
+                                          : max_thread_count_;
+  if (options.enable_metrics) {
+    worker_stats_.reserve(slot_count);
+    for (size_t i = 0; i < slot_count; ++i) {
+      worker_stats_.emplace_back(new WorkerStats());
+    }
+  }
+
+  if (work_stealing_) {
+    workers_.reserve(options.thread_count);
+    for (size_t i = 0; i < options.thread_count; ++i) {
+      workers_.emplace_back([this, i]() {
+        InitWorkerThread(i);
+        WorkStealingWorkerLoop(i);
+      });
+    }
+    worker_count_ = workers_.size();
+  } else {
+    std::lock_guard<std::mutex> lk(queue_mtx_);
+    workers_.reserve(max_thread_count_);
+    for (size_t i = slot_count; i > 0; --i) {
+      free_slots_.push_back(i - 1);
+    }
+    for (size_t i = 0; i < options.thread_count; ++i) {
+      SpawnWorkerLocked();
+    }
+    // The initial workers are not resize events
+    grow_count_ = 0;
   }
 }
 
 ThreadPool::~ThreadPool()
 {
+  Shutdown(ShutdownMode::kRUN_REMAINING);
+}
+
+void
+ThreadPool::InitWorkerThread(size_t index)
+{
+#ifdef __linux__
+  if (!cpus_.empty()) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpus_[index % cpus_.size()], &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+  }
+  if (!thread_name_.empty()) {
+    // Thread names are limited to 16 bytes including the terminator
+    const std::string name =
+        (thread_name_ + std::to_string(index)).substr(0, 15);
+    pthread_setname_np(pthread_self(), name.c_str());
+  }
+  if (nice_level_) {
+    // On Linux the nice level is a per-thread attribute
+    setpriority(
+        PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), *nice_level_);
+  }
+#endif  // __linux__
+}
+
+void
+ThreadPool::SpawnWorkerLocked()
+{
+  // Caller must hold 'queue_mtx_'. Retired workers have released the lock
+  // for good and are about to return, so joining them here is quick.
+  for (auto& t : retired_workers_) {
+    t.join();
+  }
+  retired_workers_.clear();
+
+  const size_t slot = free_slots_.back();
+  free_slots_.pop_back();
+  workers_.emplace_back([this, slot]() {
+    InitWorkerThread(slot);
+    WorkerLoop(slot);
+  });
+  worker_count_ = workers_.size();
+  grow_count_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void
+ThreadPool::RetireWorkerLocked(size_t slot)
+{
+  // Caller must hold 'queue_mtx_' and be the retiring worker
+  const auto id = std::this_thread::get_id();
+  for (auto it = workers_.begin(); it != workers_.end(); ++it) {
+    if (it->get_id() == id) {
+      retired_workers_.emplace_back(std::move(*it));
+      workers_.erase(it);
+      break;
+    }
+  }
+  free_slots_.push_back(slot);
+  worker_count_ = workers_.size();
+  shrink_count_.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool
+ThreadPool::ShouldGrowLocked()
+{
+  // Caller must hold 'queue_mtx_'
+  if (!elastic_ || stop_ || (workers_.size() >= max_thread_count_)) {
+    return false;
+  }
+  if ((queued_count_ > idle_count_) &&
+      ((queued_count_ - idle_count_) > grow_queue_depth_)) {
+    return true;
+  }
+  if ((grow_wait_time_.count() > 0) && (queued_count_ != 0)) {
+    const auto now = std::chrono::steady_clock::now();
+    for (auto& queue : task_queues_) {
+      if (!queue.empty() &&
+          ((now - queue.front().enqueue_time_) >= grow_wait_time_)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+ThreadPool&
+ThreadPool::NodePool()
+{
+#ifdef __linux__
+  const int cpu = sched_getcpu();
+  if ((cpu >= 0) && (static_cast<size_t>(cpu) < cpu_node_pools_.size()) &&
+      (cpu_node_pools_[cpu] >= 0)) {
+    return *node_pools_[cpu_node_pools_[cpu]];
+  }
+#endif  // __linux__
+  return *node_pools_
+      [next_node_pool_.fetch_add(1, std::memory_order_relaxed) %
+       node_pools_.size()];
+}
+
+template <typename Predicate>
+bool
+ThreadPool::SpinForWork(uint32_t* spin_budget, Predicate has_work)
+{
+  for (uint32_t i = 0; i < *spin_budget; ++i) {
+    if (has_work()) {
+      *spin_budget = spin_count_;
+      return true;
+    }
+    CpuRelax();
+  }
+  *spin_budget = std::max(*spin_budget / 2, spin_count_ / 8);
+  return has_work();
+}
+
+template <typename Predicate>
+void
+ThreadPool::WaitForWork(uint32_t* spin_budget, Predicate has_work)
+{
+  if (SpinForWork(spin_budget, has_work)) {
+    return;
+  }
+  while (!has_work()) {
+    work_ec_.PrepareWait();
+    if (has_work()) {
+      work_ec_.CancelWait();
+      break;
+    }
+    work_ec_.Wait();
+  }
+}
+
+void
+ThreadPool::WorkerLoop(size_t slot)
+{
+  std::vector<QueuedTask> tasks;
+  tasks.reserve(max_tasks_per_wakeup_);
+  WorkerStats* stats =
+      worker_stats_.empty() ? nullptr : worker_stats_[slot].get();
+
+  // Wake if there's a task to do, or the pool has been stopped.
+  auto has_work = [this]() { return (queued_count_ != 0) || stop_; };
+  uint32_t spin_budget = spin_count_;
+
+  // Infinite loop for each thread to wait for a task to complete
+  while (true) {
+    // Idle workers of elastic pools are not spinning, they count as idle
+    // for the growth decisions
+    if (!elastic_) {
+      WaitForWork(&spin_budget, has_work);
+    }
+    {
+      std::unique_lock<std::mutex> lk(queue_mtx_);
+      if (elastic_) {
+        ++idle_count_;
+        if (!cv_.wait_for(lk, keepalive_, has_work) &&
+            (workers_.size() > min_thread_count_)) {
+          // Idle for longer than the keepalive
+          --idle_count_;
+          RetireWorkerLocked(slot);
+          return;
+        }
+        --idle_count_;
+      } else if (!has_work()) {
+        // Another worker took the task
+        continue;
+      }
+      // Exit condition
+      if (stop_ && (queued_count_ == 0)) {
+        break;
+      }
+      QueuedTask task;
+      while ((tasks.size() < max_tasks_per_wakeup_) && PopTaskLocked(&task)) {
+        tasks.emplace_back(std::move(task));
+      }
+      // Tasks left behind have been waiting for a worker
+      if (ShouldGrowLocked()) {
+        SpawnWorkerLocked();
+      }
+    }
+
+    for (auto& task : tasks) {
+      RunTask(task, stats);
+    }
+    tasks.clear();
+  }
+}
+
+void
+ThreadPool::WorkStealingWorkerLoop(size_t index)
+{
+  tls_pool = this;
+  tls_worker_index = index;
+  uint32_t seed = static_cast<uint32_t>(index) * 2654435761u + 1;
+  WorkerStats* stats =
+      worker_stats_.empty() ? nullptr : worker_stats_[index].get();
+
+  auto has_work = [this]() { return stop_ || HasQueuedTasks(); };
+  uint32_t spin_budget = spin_count_;
+
+  while (true) {
+    QueuedTask task;
+    if (FindTask(index, &seed, &task)) {
+      RunTask(task, stats);
+      continue;
+    }
+
+    WaitForWork(&spin_budget, has_work);
+    if (stop_ && !HasQueuedTasks()) {
+      break;
+    }
+  }
+
+  tls_pool = nullptr;
+}
+
+void
+ThreadPool::RunTask(QueuedTask& queued, WorkerStats* stats)
+{
+  if (discard_.load(std::memory_order_relaxed)) {
+    discarded_count_.fetch_add(1, std::memory_order_relaxed);
+  } else if (
+      queued.cancelled_ && queued.cancelled_->load(std::memory_order_acquire)) {
+    // Cancelled before it started
+  } else if (queued.task_) {
+    // Ensure function has a valid target
+    if (stats == nullptr) {
+      queued.task_();
+    } else {
+      const auto start = std::chrono::steady_clock::now();
+      queued.task_();
+      const auto end = std::chrono::steady_clock::now();
+      stats->Record(start - queued.enqueue_time_, end - start);
+    }
+  }
+  // Release what the task holds before it counts as finished for Drain()
+  queued.task_.Reset();
+  queued.cancelled_.reset();
+  FinishTasks(1);
+}
+
+void
+ThreadPool::FinishTasks(size_t count)
+{
+  if ((count != 0) && (pending_count_.fetch_sub(count) == count) &&
+      (drain_waiters_.load() != 0)) {
+    // Taking the lock guarantees the drainer is waiting on 'drain_cv_' and
+    // will not miss the notification.
+    std::lock_guard<std::mutex> lk(queue_mtx_);
+    drain_cv_.notify_all();
+  }
+}
+
+bool
+ThreadPool::FindTask(size_t index, uint32_t* seed, QueuedTask* task)
+{
+  // Newest task from own deque first, it is the most likely to be cache-hot.
+  Worker& worker = *stealing_workers_[index];
+  if (worker.Pop(task)) {
+    return true;
+  }
+
+  // Then tasks enqueued from outside the pool, moving up to
+  // 'max_tasks_per_wakeup_' of them to own deque at once.
+  {
+    std::lock_guard<std::mutex> lk(queue_mtx_);
+    if (PopTaskLocked(task)) {
+      size_t moved = 0;
+      QueuedTask extra;
+      for (; ((moved + 1) < max_tasks_per_wakeup_) && PopTaskLocked(&extra);
+           ++moved) {
+        worker.Push(std::move(extra));
+      }
+      // Let a parked peer steal the moved tasks
+      if (moved != 0) {
+        work_ec_.Notify();
+      }
+      return true;
+    }
+  }
+
+  // Then the oldest task of a peer, starting from a random victim.
+  const size_t count = stealing_workers_.size();
+  const size_t start = NextRandom(seed) % count;
+  for (size_t i = 0; i < count; ++i) {
+    const size_t victim = (start + i) % count;
+    if ((victim != index) && stealing_workers_[victim]->Steal(task)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool
+ThreadPool::HasQueuedTasks()
+{
+  // Lock-free, pairs with 'work_ec_' to decide whether to park
+  if (queued_count_ != 0) {
+    return true;
+  }
+  for (const auto& worker : stealing_workers_) {
+    if (!worker->deque_.Empty()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool
+ThreadPool::PopTaskLocked(QueuedTask* task)
+{
+  const size_t queued_count = queued_count_.load(std::memory_order_relaxed);
+  if (queued_count == 0) {
+    return false;
+  }
+  auto& queue = task_queues_[SelectLevelLocked()];
+  *task = std::move(queue.front());
+  queue.pop();
+  queued_count_.store(queued_count - 1, std::memory_order_relaxed);
+  return true;
+}
+
+size_t
+ThreadPool::SelectLevelLocked()
+{
+  // Caller must hold 'queue_mtx_' and ensure at least one task is queued
+  const size_t level_count = task_queues_.size();
+  if (level_count == 1) {
+    return 0;
+  }
+
+  // The oldest task that exceeded the aging threshold goes first
+  if (aging_threshold_.count() > 0) {
+    const auto now = std::chrono::steady_clock::now();
+    size_t aged = level_count;
+    for (size_t i = 0; i < level_count; ++i) {
+      if (!task_queues_[i].empty() &&
+          ((now - task_queues_[i].front().enqueue_time_) >= aging_threshold_) &&
+          ((aged == level_count) ||
+           (task_queues_[i].front().enqueue_time_ <
+            task_queues_[aged].front().enqueue_time_))) {
+        aged = i;
+      }
+    }
+    if (aged != level_count) {
+      return aged;
+    }
+  }
+
+  size_t selected = level_count;
+  for (size_t i = 0; i < level_count; ++i) {
+    if (task_queues_[i].empty()) {
+      continue;
+    }
+    if (priority_policy_ == PriorityPolicy::kSTRICT) {
+      return i;
+    }
+    if ((selected == level_count) || (passes_[i] < passes_[selected])) {
+      selected = i;
+    }
+  }
+  current_pass_ = passes_[selected];
+  passes_[selected] += strides_[selected];
+  return selected;
+}
+
+bool
+ThreadPool::Enqueue(Task&& task, uint32_t priority_level)
+{
+  return EnqueueImpl(std::move(task), nullptr, priority_level);
+}
+
+bool
+ThreadPool::Enqueue(
+    Task&& task, const CancellationToken& token, uint32_t priority_level)
+{
+  std::shared_ptr<std::atomic<bool>> cancelled = token.cancelled_;
+  return EnqueueImpl(std::move(task), std::move(cancelled), priority_level);
+}
+
+bool
+ThreadPool::EnqueueImpl(
+    Task&& task, std::shared_ptr<std::atomic<bool>>&& cancelled,
+    uint32_t priority_level)
+{
+  if (!node_pools_.empty()) {
+    return NodePool().EnqueueImpl(
+        std::move(task), std::move(cancelled), priority_level);
+  }
+
+  // Tasks enqueued by one of this pool's workers go to its own deque
+  if (work_stealing_ && (tls_pool == this)) {
+    if (stop_) {
+      return false;
+    }
+    if (!worker_stats_.empty()) {
+      tasks_enqueued_.fetch_add(1, std::memory_order_relaxed);
+    }
+    pending_count_.fetch_add(1);
+    stealing_workers_[tls_worker_index]->Push(QueuedTask{
+        std::move(task),
+        record_enqueue_time_ ? std::chrono::steady_clock::now()
+                             : std::chrono::steady_clock::time_point(),
+        std::move(cancelled)});
+    work_ec_.Notify();
+    return true;
+  }
+
+  bool wake_waiter = false;
+  const size_t level = ((priority_level >= 1) &&
+                        (priority_level <= task_queues_.size()) &&
+                        !strides_.empty())
+                           ? (priority_level - 1)
+                           : default_level_index_;
+  {
+    std::lock_guard<std::mutex> lk(queue_mtx_);
+    // Don't accept more work if pool is shutting down
+    if (stop_) {
+      return false;
+    }
+    auto& queue = task_queues_[level];
+    // A level that was idle must not catch up on the passes it missed
+    if (queue.empty() && !passes_.empty() &&
+        (passes_[level] < current_pass_)) {
+      passes_[level] = current_pass_;
+    }
+    pending_count_.fetch_add(1);
+    queue.push(QueuedTask{
+        std::move(task),
+        record_enqueue_time_ ? std::chrono::steady_clock::now()
+                             : std::chrono::steady_clock::time_point(),
+        std::move(cancelled)});
+    const size_t queued_count =
+        queued_count_.load(std::memory_order_relaxed) + 1;
+    queued_count_.store(queued_count, std::memory_order_relaxed);
+    if (queued_count > peak_queue_depth_.load(std::memory_order_relaxed)) {
+      peak_queue_depth_.store(queued_count, std::memory_order_relaxed);
+    }
+    if (!worker_stats_.empty()) {
+      tasks_enqueued_.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (ShouldGrowLocked()) {
+      SpawnWorkerLocked();
+    }
+    wake_waiter = (idle_count_ != 0);
+  }
+  // Only wake one thread per task, and only make a system call if a worker
+  // is waiting
+  if (elastic_) {
+    if (wake_waiter) {
+      cv_.notify_one();
+    }
+  } else {
+    work_ec_.Notify();
+  }
+  return true;
+}
+
+bool
+ThreadPool::Drain(std::chrono::steady_clock::time_point deadline)
+{
+  if (!node_pools_.empty()) {
+    bool drained = true;
+    for (const auto& pool : node_pools_) {
+      drained = pool->Drain(deadline) && drained;
+    }
+    return drained;
+  }
+
+  std::unique_lock<std::mutex> lk(queue_mtx_);
+  // Announce the waiter before checking 'pending_count_', pairs with
+  // 'FinishTasks' so the last task either is seen finished here or sees
+  // the waiter and notifies it.
+  drain_waiters_.fetch_add(1);
+  auto idle = [this]() { return pending_count_.load() == 0; };
+  bool drained = true;
+  if (deadline == std::chrono::steady_clock::time_point::max()) {
+    drain_cv_.wait(lk, idle);
+  } else {
+    drained = drain_cv_.wait_until(lk, deadline, idle);
+  }
+  drain_waiters_.fetch_sub(1);
+  return drained;
+}
+
+size_t
+ThreadPool::Shutdown(ShutdownMode mode)
+{
+  std::lock_guard<std::mutex> shutdown_lk(shutdown_mtx_);
+  if (!node_pools_.empty()) {
+    stop_ = true;
+    size_t discarded = 0;
+    for (const auto& pool : node_pools_) {
+      discarded += pool->Shutdown(mode);
+    }
+    return discarded;
+  }
+
+  std::vector<QueuedTask> discarded;
   {
     std::lock_guard<std::mutex> lk(queue_mtx_);
     // Signal to each worker that it should exit loop when tasks are finished
     stop_ = true;
+    if (mode == ShutdownMode::kDISCARD_REMAINING) {
+      // Tasks already taken by the workers, or in the work-stealing deques,
+      // are discarded by the workers
+      discard_ = true;
+      QueuedTask task;
+      while (PopTaskLocked(&task)) {
+        discarded.emplace_back(std::move(task));
+      }
+    }
   }
   // Wake all threads to clean up
   cv_.notify_all();
+  work_ec_.NotifyAll();
+
+  const size_t discarded_count = discarded.size();
+  discarded.clear();
+  FinishTasks(discarded_count);
+
+  // Workers no longer retire once 'stop_' is set, so 'workers_' is stable.
   for (auto& t : workers_) {
     t.join();
   }
+  for (auto& t : retired_workers_) {
+    t.join();
+  }
+  workers_.clear();
+  retired_workers_.clear();
+  worker_count_ = 0;
+  return discarded_count + discarded_count_.exchange(0);
 }
 
-void
-ThreadPool::Enqueue(Task&& task)
+size_t
+ThreadPool::TaskQueueSize()
 {
-  {
-    std::lock_guard<std::mutex> lk(queue_mtx_);
-    // Don't accept more work if pool is shutting down
-    if (stop_) {
-      return;
+  if (!node_pools_.empty()) {
+    size_t size = 0;
+    for (const auto& pool : node_pools_) {
+      size += pool->TaskQueueSize();
+    }
+    return size;
+  }
+  size_t size = queued_count_.load(std::memory_order_relaxed);
+  for (const auto& worker : stealing_workers_) {
+    size += worker->deque_.Size();
+  }
+  return size;
+}
+
+size_t
+ThreadPool::TaskQueueSize(uint32_t priority_level)
+{
+  if (!node_pools_.empty()) {
+    size_t size = 0;
+    for (const auto& pool : node_pools_) {
+      size += pool->TaskQueueSize(priority_level);
+    }
+    return size;
+  }
+  if (strides_.empty() || (priority_level < 1) ||
+      (priority_level > task_queues_.size())) {
+    return 0;
+  }
+  std::lock_guard<std::mutex> lk(queue_mtx_);
+  return task_queues_[priority_level - 1].size();
+}
+
+size_t
+ThreadPool::Size() const
+{
+  if (!node_pools_.empty()) {
+    size_t size = 0;
+    for (const auto& pool : node_pools_) {
+      size += pool->Size();
+    }
+    return size;
+  }
+  return worker_count_;
+}
+
+ThreadPool::ResizeCounters
+ThreadPool::GetResizeCounters() const
+{
+  ResizeCounters counters;
+  for (const auto& pool : node_pools_) {
+    const ResizeCounters node_counters = pool->GetResizeCounters();
+    counters.grow_count += node_counters.grow_count;
+    counters.shrink_count += node_counters.shrink_count;
+  }
+  counters.grow_count += grow_count_.load(std::memory_order_relaxed);
+  counters.shrink_count += shrink_count_.load(std::memory_order_relaxed);
+  return counters;
+}
+
+ThreadPool::Metrics
+ThreadPool::GetMetrics() const
+{
+  Metrics metrics;
+  metrics.uptime = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - start_time_);
+  metrics.resize_counters = GetResizeCounters();
+
+  // Sub-pools are merged, their workers listed node by node
+  for (const auto& pool : node_pools_) {
+    const Metrics node_metrics = pool->GetMetrics();
+    metrics.tasks_enqueued += node_metrics.tasks_enqueued;
+    metrics.tasks_completed += node_metrics.tasks_completed;
+    metrics.queue_depth += node_metrics.queue_depth;
+    metrics.peak_queue_depth += node_metrics.peak_queue_depth;
+    metrics.total_queue_wait += node_metrics.total_queue_wait;
+    metrics.total_run_time += node_metrics.total_run_time;
+    for (size_t i = 0; i < kHistogramBuckets; ++i) {
+      metrics.queue_wait_histogram[i] += node_metrics.queue_wait_histogram[i];
+      metrics.run_time_histogram[i] += node_metrics.run_time_histogram[i];
+    }
+    metrics.workers.insert(
+        metrics.workers.end(), node_metrics.workers.begin(),
+        node_metrics.workers.end());
+  }
+  if (!node_pools_.empty()) {
+    return metrics;
+  }
+
+  metrics.tasks_enqueued = tasks_enqueued_.load(std::memory_order_relaxed);
+  metrics.queue_depth = queued_count_.load(std::memory_order_relaxed);
+  metrics.peak_queue_depth =
+      peak_queue_depth_.load(std::memory_order_relaxed);
+  for (const auto& stats : worker_stats_) {
+    WorkerMetrics worker;
+    worker.tasks_completed =
+        stats->tasks_completed_.load(std::memory_order_relaxed);
+    worker.busy_time = std::chrono::nanoseconds(
+        stats->busy_ns_.load(std::memory_order_relaxed));
+    if (metrics.uptime.count() > 0) {
+      worker.busy_ratio = static_cast<double>(worker.busy_time.count()) /
+                          static_cast<double>(metrics.uptime.count());
+    }
+    metrics.tasks_completed += worker.tasks_completed;
+    metrics.total_run_time += worker.busy_time;
+    metrics.total_queue_wait += std::chrono::nanoseconds(
+        stats->wait_ns_.load(std::memory_order_relaxed));
+    for (size_t i = 0; i < kHistogramBuckets; ++i) {
+      metrics.queue_wait_histogram[i] +=
+          stats->wait_histogram_[i].load(std::memory_order_relaxed);
+      metrics.run_time_histogram[i] +=
+          stats->run_histogram_[i].load(std::memory_order_relaxed);
     }
-    task_queue_.push(std::move(task));
+    metrics.workers.push_back(worker);
   }
-  // Only wake one thread per task
-  // Todo: DLIS-3859 if ThreadPool gets used more.
-  cv_.notify_one();
+  return metrics;
 }
 
 }}  // namespace triton::common
@@ -0,0 +1,294 @@
+// Copyright 2026, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "triton/common/timer_wheel.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace triton { namespace common {
+
+namespace {
+
+// Returns the index of the lowest set bit of non-zero 'bits'.
+size_t
+LowestSetBit(uint64_t bits)
+{
+#ifdef _MSC_VER
+  unsigned long index;
+  _BitScanForward64(&index, bits);
+  return index;
+#else
+  return __builtin_ctzll(bits);
+#endif
+}
+
+}  // namespace
+
+TimerWheel::TimerWheel(ThreadPool* pool, std::chrono::microseconds tick)
+    : pool_(pool), tick_(tick), start_(Clock::now())
+{
+  if (tick_.count() <= 0) {
+    throw std::invalid_argument("Timer wheel tick must be positive");
+  }
+  heads_.fill(kNil);
+  thread_ = std::thread(&TimerWheel::TimerThread, this);
+}
+
+TimerWheel::~TimerWheel()
+{
+  {
+    std::lock_guard<std::mutex> lk(mtx_);
+    exit_ = true;
+  }
+  cv_.notify_all();
+  thread_.join();
+}
+
+TimerWheel::TimerId
+TimerWheel::ScheduleAt(Clock::time_point deadline, Task&& task)
+{
+  std::lock_guard<std::mutex> lk(mtx_);
+  if (pending_count_ == 0) {
+    // Nothing is placed relative to the last processed tick, skip the
+    // ticks passed while the wheel was empty.
+    const uint64_t now_tick = (Clock::now() - start_) / tick_;
+    if (now_tick > current_tick_) {
+      current_tick_ = now_tick;
+    }
+  }
+  const uint64_t expiry = std::max(TickAt(deadline), current_tick_ + 1);
+  const bool wake =
+      (pending_count_ == 0) || (expiry < NextWakeTickLocked());
+
+  uint32_t index;
+  if (!free_timers_.empty()) {
+    index = free_timers_.back();
+    free_timers_.pop_back();
+  } else {
+    index = timers_.size();
+    timers_.emplace_back();
+  }
+  Timer& timer = timers_[index];
+  timer.task_ = std::move(task);
+  timer.expiry_ = expiry;
+  InsertLocked(index);
+  ++pending_count_;
+
+  if (wake) {
+    cv_.notify_one();
+  }
+  return (uint64_t(timer.generation_) << 32) | (uint64_t(index) + 1);
+}
+
+bool
+TimerWheel::Cancel(TimerId id)
+{
+  // Destroy the task outside the lock
+  Task task;
+  {
+    std::lock_guard<std::mutex> lk(mtx_);
+    const uint64_t index = (id & UINT32_MAX) - 1;
+    if ((index >= timers_.size()) ||
+        (timers_[index].generation_ != (id >> 32)) ||
+        (timers_[index].slot_ == kNil)) {
+      return false;
+    }
+    UnlinkLocked(index);
+    task = std::move(timers_[index].task_);
+    FreeLocked(index);
+  }
+  return true;
+}
+
+size_t
+TimerWheel::PendingCount() const
+{
+  std::lock_guard<std::mutex> lk(mtx_);
+  return pending_count_;
+}
+
+void
+TimerWheel::TimerThread()
+{
+  std::vector<Task> expired;
+  std::unique_lock<std::mutex> lk(mtx_);
+  while (!exit_) {
+    if (pending_count_ == 0) {
+      cv_.wait(lk);
+      continue;
+    }
+    // Woken early by a timer due before the wake tick, or to exit
+    const Clock::time_point now = Clock::now();
+    const Clock::time_point wake_time =
+        start_ + tick_ * NextWakeTickLocked();
+    if (now < wake_time) {
+      cv_.wait_until(lk, wake_time);
+      continue;
+    }
+
+    AdvanceLocked((now - start_) / tick_, &expired);
+    lk.unlock();
+    for (auto& task : expired) {
+      pool_->Enqueue(std::move(task));
+    }
+    expired.clear();
+    lk.lock();
+  }
+}
+
+uint64_t
+TimerWheel::TickAt(Clock::time_point time) const
+{
+  if (time <= start_) {
+    return 0;
+  }
+  return ((time - start_) + tick_ - Clock::duration(1)) / tick_;
+}
+
+void
+TimerWheel::InsertLocked(uint32_t index)
+{
+  Timer& timer = timers_[index];
+  constexpr uint64_t kMaxDelta = (uint64_t(1) << (kLevels * kSlotBits)) - 1;
+  uint64_t delta = timer.expiry_ - current_tick_;
+  uint64_t placement = timer.expiry_;
+  if (delta > kMaxDelta) {
+    // Parked in the last level until it is in range
+    delta = kMaxDelta;
+    placement = current_tick_ + kMaxDelta;
+  }
+  size_t level = 0;
+  while ((level < kLevels - 1) &&
+         (delta >= (uint64_t(1) << ((level + 1) * kSlotBits)))) {
+    ++level;
+  }
+  const size_t slot = (placement >> (level * kSlotBits)) & kSlotMask;
+  const uint32_t head_index = level * kSlots + slot;
+
+  timer.slot_ = head_index;
+  timer.prev_ = kNil;
+  timer.next_ = heads_[head_index];
+  if (timer.next_ != kNil) {
+    timers_[timer.next_].prev_ = index;
+  }
+  heads_[head_index] = index;
+  occupied_[level] |= (uint64_t(1) << slot);
+}
+
+void
+TimerWheel::UnlinkLocked(uint32_t index)
+{
+  Timer& timer = timers_[index];
+  const uint32_t head_index = timer.slot_;
+  if (timer.prev_ != kNil) {
+    timers_[timer.prev_].next_ = timer.next_;
+  } else {
+    heads_[head_index] = timer.next_;
+  }
+  if (timer.next_ != kNil) {
+    timers_[timer.next_].prev_ = timer.prev_;
+  }
+  if (heads_[head_index] == kNil) {
+    occupied_[head_index / kSlots] &=
+        ~(uint64_t(1) << (head_index % kSlots));
+  }
+  timer.slot_ = kNil;
+}
+
+void
+TimerWheel::FreeLocked(uint32_t index)
+{
+  // Invalidate the timer's ID
+  ++timers_[index].generation_;
+  free_timers_.push_back(index);
+  --pending_count_;
+}
+
+void
+TimerWheel::CascadeLocked(uint64_t tick)
+{
+  for (size_t level = 1; level < kLevels; ++level) {
+    const size_t slot = (tick >> (level * kSlotBits)) & kSlotMask;
+    const uint32_t head_index = level * kSlots + slot;
+    uint32_t index = heads_[head_index];
+    heads_[head_index] = kNil;
+    occupied_[level] &= ~(uint64_t(1) << slot);
+    while (index != kNil) {
+      const uint32_t next = timers_[index].next_;
+      InsertLocked(index);
+      index = next;
+    }
+    // The next level is only reached when this one wraps around
+    if (slot != 0) {
+      break;
+    }
+  }
+}
+
+void
+TimerWheel::AdvanceLocked(uint64_t tick, std::vector<Task>* expired)
+{
+  while (current_tick_ < tick) {
+    const uint64_t next = NextWakeTickLocked();
+    if ((pending_count_ == 0) || (next > tick)) {
+      current_tick_ = tick;
+      break;
+    }
+    current_tick_ = next;
+    if ((next & kSlotMask) == 0) {
+      CascadeLocked(next);
+    }
+    const uint32_t head_index = next & kSlotMask;
+    while (heads_[head_index] != kNil) {
+      const uint32_t index = heads_[head_index];
+      UnlinkLocked(index);
+      expired->emplace_back(std::move(timers_[index].task_));
+      FreeLocked(index);
+    }
+  }
+}
+
+uint64_t
+TimerWheel::NextWakeTickLocked() const
+{
+  // The first level is only scanned up to the next cascade
+  const uint64_t from = current_tick_ + 1;
+  if ((from & kSlotMask) == 0) {
+    return from;
+  }
+  const uint64_t occupied = occupied_[0] >> (from & kSlotMask);
+  if (occupied != 0) {
+    return from + LowestSetBit(occupied);
+  }
+  return (current_tick_ | kSlotMask) + 1;
+}
+
+}}  // namespace triton::common
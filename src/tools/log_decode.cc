@@ -0,0 +1,329 @@
+// Copyright 2026, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//
+// triton-log-decode: writes the records of binary logs, see
+// Logger::SetBinaryLog(), to stdout in the default, ISO8601 or JSON log
+// format, merged across threads and processes in timestamp order.
+//
+//   triton-log-decode [--format=default|ISO8601|JSON] <path>...
+//
+// Each path is a binary log directory, or a ring or sites file of one.
+//
+
+#include <dirent.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "triton/common/logging.h"
+
+namespace tc = triton::common;
+
+namespace {
+
+// LOG_VERBOSE_FMT call site of a sites file.
+struct Site {
+  std::string file;
+  int32_t line;
+  std::string format;
+};
+
+// Call sites of a process by id, and of each process by pid.
+using ProcessSites = std::map<uint32_t, Site>;
+using Sites = std::map<uint32_t, ProcessSites>;
+
+// A decoded record.
+struct Record {
+  uint64_t timestamp_ns;
+  uint32_t pid;
+  uint64_t tid;
+  uint8_t level;
+  bool verbose;
+  bool escape_heading;
+  bool escape;
+  int32_t line;
+  std::string file;
+  std::string heading;
+  std::string message;
+};
+
+bool
+HasSuffix(const std::string& str, const std::string& suffix)
+{
+  return (str.size() >= suffix.size()) &&
+         (str.compare(str.size() - suffix.size(), suffix.size(), suffix) ==
+          0);
+}
+
+bool
+ReadFile(const std::string& path, std::string* content)
+{
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    return false;
+  }
+  std::stringstream buffer;
+  buffer << file.rdbuf();
+  *content = buffer.str();
+  return !file.bad();
+}
+
+// Parse the sites file 'content' into the sites of its process.
+bool
+ParseSites(const std::string& content, Sites* sites)
+{
+  const char* in = content.data();
+  const char* end = in + content.size();
+  auto read_u32 = [&in, end](uint32_t* value) {
+    if (static_cast<size_t>(end - in) < sizeof(*value)) {
+      return false;
+    }
+    std::memcpy(value, in, sizeof(*value));
+    in += sizeof(*value);
+    return true;
+  };
+  auto read_string = [&in, end, &read_u32](std::string* value) {
+    uint32_t size;
+    if (!read_u32(&size) || (static_cast<size_t>(end - in) < size)) {
+      return false;
+    }
+    value->assign(in, size);
+    in += size;
+    return true;
+  };
+  uint32_t version, pid;
+  if ((content.size() < sizeof(tc::kLogBinarySitesMagic)) ||
+      (std::memcmp(
+           in, tc::kLogBinarySitesMagic, sizeof(tc::kLogBinarySitesMagic)) !=
+       0)) {
+    return false;
+  }
+  in += sizeof(tc::kLogBinarySitesMagic);
+  if (!read_u32(&version) || (version != tc::kLogBinaryVersion) ||
+      !read_u32(&pid)) {
+    return false;
+  }
+  ProcessSites& process_sites = (*sites)[pid];
+  // A truncated entry is the last one, written while the process stopped
+  while (in != end) {
+    uint32_t id, line;
+    Site site;
+    if (!read_u32(&id) || !read_u32(&line) || !read_string(&site.file) ||
+        !read_string(&site.format)) {
+      break;
+    }
+    site.line = static_cast<int32_t>(line);
+    process_sites[id] = std::move(site);
+  }
+  return true;
+}
+
+// Write the values from 'in' to 'end' as the message of 'site', see
+// tc::LogFormatTo().
+std::string
+FormatMessage(const Site& site, const char* in, const char* end)
+{
+  std::ostringstream out;
+  tc::LogBinaryValue value;
+  const char* format = site.format.c_str();
+  while ((format = tc::LogFormatText(out, format)) != nullptr) {
+    if ((in != nullptr) && ((in = value.Read(in, end)) != nullptr)) {
+      out << value;
+    } else {
+      out << "{}";
+    }
+  }
+  return out.str();
+}
+
+// Parse the ring file 'content', whose LOG_VERBOSE_FMT records are those of
+// 'sites', appending its records to 'records'.
+bool
+ParseRing(
+    const std::string& content, const Sites& sites,
+    std::vector<Record>* records)
+{
+  const auto* header =
+      reinterpret_cast<const tc::LogBinaryRingHeader*>(content.data());
+  static const ProcessSites kNoSites;
+  const auto process_sites = (content.size() >= sizeof(*header))
+                                 ? sites.find(header->pid)
+                                 : sites.end();
+  const ProcessSites& ring_sites =
+      (process_sites != sites.end()) ? process_sites->second : kNoSites;
+  return tc::ForEachLogBinaryRecord(
+      content.data(), content.size(),
+      [&](const tc::LogBinaryRecordHeader& record_header, const char* in,
+          const char* end) {
+        Record record;
+        record.timestamp_ns = record_header.timestamp_ns;
+        record.pid = header->pid;
+        record.tid = header->tid;
+        record.level = static_cast<uint8_t>(tc::Logger::Level::kINFO);
+        record.verbose = true;
+        record.escape_heading = true;
+        record.escape = true;
+        if (record_header.site != tc::kLogBinaryMessageSite) {
+          const auto site = ring_sites.find(record_header.site);
+          if (site == ring_sites.end()) {
+            record.file = "?";
+            record.line = 0;
+            record.message = "<unknown LOG_VERBOSE_FMT call site " +
+                             std::to_string(record_header.site) + ">";
+          } else {
+            record.file = site->second.file;
+            record.line = site->second.line;
+            record.message = FormatMessage(site->second, in, end);
+          }
+          records->push_back(std::move(record));
+          return;
+        }
+        tc::LogBinaryValue values[8];
+        for (auto& value : values) {
+          if ((in == nullptr) || ((in = value.Read(in, end)) == nullptr)) {
+            return;
+          }
+        }
+        record.level = std::min<uint64_t>(
+            values[0].UInt(), static_cast<uint8_t>(tc::Logger::Level::kINFO));
+        record.verbose = (values[1].UInt() != 0);
+        record.escape_heading = (values[2].UInt() != 0);
+        record.escape = (values[3].UInt() != 0);
+        record.line = static_cast<int32_t>(values[4].Int());
+        record.file = values[5].String();
+        record.heading = values[6].String();
+        record.message = values[7].String();
+        records->push_back(std::move(record));
+      });
+}
+
+// Format 'record' as the logger does in 'format'.
+std::string
+FormatRecord(const Record& record, tc::Logger::Format format)
+{
+  std::string out;
+  tc::LogFormatRecord(
+      &out, format,
+      {static_cast<tc::Logger::Level>(record.level), record.verbose,
+       record.timestamp_ns / 1000, record.pid, record.tid, record.file,
+       record.line, record.heading.empty() ? nullptr : record.heading.c_str(),
+       record.message, record.escape_heading, record.escape});
+  return out;
+}
+
+int
+Usage(const char* program)
+{
+  std::cerr << "Usage: " << program
+            << " [--format=default|ISO8601|JSON] <path>..." << std::endl
+            << "Writes the records of the binary log directories or files "
+               "to stdout."
+            << std::endl;
+  return 2;
+}
+
+}  // namespace
+
+int
+main(int argc, char** argv)
+{
+  tc::Logger::Format format = tc::Logger::Format::kDEFAULT;
+  std::vector<std::string> sites_files, ring_files;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg.rfind("--format=", 0) == 0) {
+      const std::string name = arg.substr(9);
+      if (name == "default") {
+        format = tc::Logger::Format::kDEFAULT;
+      } else if (name == "ISO8601") {
+        format = tc::Logger::Format::kISO8601;
+      } else if (name == "JSON") {
+        format = tc::Logger::Format::kJSON;
+      } else {
+        return Usage(argv[0]);
+      }
+    } else if (arg.rfind("--", 0) == 0) {
+      return Usage(argv[0]);
+    } else if (HasSuffix(arg, ".sites")) {
+      sites_files.push_back(arg);
+    } else if (HasSuffix(arg, ".blog")) {
+      ring_files.push_back(arg);
+    } else {
+      DIR* dir = opendir(arg.c_str());
+      if (dir == nullptr) {
+        std::cerr << arg << ": " << std::strerror(errno) << std::endl;
+        return 1;
+      }
+      for (struct dirent* entry; (entry = readdir(dir)) != nullptr;) {
+        const std::string name = entry->d_name;
+        if (HasSuffix(name, ".sites")) {
+          sites_files.push_back(arg + "/" + name);
+        } else if (HasSuffix(name, ".blog")) {
+          ring_files.push_back(arg + "/" + name);
+        }
+      }
+      closedir(dir);
+    }
+  }
+  if (ring_files.empty()) {
+    return Usage(argv[0]);
+  }
+
+  int status = 0;
+  Sites sites;
+  std::string content;
+  for (const auto& path : sites_files) {
+    if (!ReadFile(path, &content) || !ParseSites(content, &sites)) {
+      std::cerr << path << ": not a binary log sites file" << std::endl;
+      status = 1;
+    }
+  }
+  std::vector<Record> records;
+  for (const auto& path : ring_files) {
+    if (!ReadFile(path, &content) || !ParseRing(content, sites, &records)) {
+      std::cerr << path << ": not a binary log ring file" << std::endl;
+      status = 1;
+    }
+  }
+  std::stable_sort(
+      records.begin(), records.end(), [](const Record& a, const Record& b) {
+        return a.timestamp_ns < b.timestamp_ns;
+      });
+  for (const auto& record : records) {
+    std::cout << FormatRecord(record, format) << '\n';
+  }
+  std::cout.flush();
+  return status;
+}